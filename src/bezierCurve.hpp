@@ -2,58 +2,87 @@
 #define BEZIER_CURVE_H
 
 #include "curve.hpp"
-#include "matrix.hpp"
 
+//! A curve made of cubic Bezier segments, P0..P3, P3..P6 and so on.
+/*!
+ * The curve is kept as its control points and tessellated into a polyline
+ * by forward differences. Each segment takes as many steps as needed for
+ * the polyline to stay within a given distance (the flatness tolerance) of
+ * the curve, so small or nearly straight segments get few points.
+ */
 class BezierCurve : public Curve {
 public:
-  BezierCurve(string name) : Curve(name) {}
+  BezierCurve(string name) : Curve(name) {
+    this->basis = BEZIER;
+  }
 
-  BezierCurve(string name, vector<Coordinate*> &coordinateList)
-    : Curve(name, CURVE, coordinateList) {
-        this->t = 0.05;
-        this->blending_function(coordinateList);
+  //! @param tolerance Largest distance allowed between the curve and its polyline.
+  BezierCurve(string name, const vector<Coordinate> &coordinateList, double tolerance)
+    : Curve(name) {
+        this->controlPoints = coordinateList;
+        this->basis = BEZIER;
+        Tessellation tessellation;
+        tessellate(tolerance, tessellation);
+        storeCoordinates(tessellation.xyz);
+        computeGeometricCenter();
   }
 
-  void setT(double newt) {
-    t = newt;
+protected:
+  void tessellate(double tolerance, Tessellation &tessellation) override {
+    // The second derivative of a cubic Bezier is 6 times its second differences
+    vector<int> steps;
+    for (size_t i = 0; i + 3 < controlPoints.size(); i += 3) {
+      const Coordinate* c = &controlPoints[i];
+      steps.push_back(LevelOfDetail::steps(6 * LevelOfDetail::secondDifference(c[0], c[1], c[2], c[3]), tolerance));
+    }
+    LevelOfDetail::limitSamples(steps, 1);
+
+    for (size_t i = 0; i + 3 < controlPoints.size(); i += 3) {
+      const Coordinate* c = &controlPoints[i];
+      double p[4][3];
+      for (int k = 0; k < 4; k++) {
+        p[k][0] = c[k].getX();
+        p[k][1] = c[k].getY();
+        p[k][2] = c[k].getZ();
+      }
+      appendSegment(p, steps[i / 3], tessellation.xyz, i == 0);
+    }
   }
 
 private:
-  double t;
-
-  void blending_function(const std::vector<Coordinate*> &v) {
-    Matrix mb = Matrix::mb();
-    double temp_t = t;
-    this->coordinateList.clear();
-
-    for (int i = 0; i < v.size() - 1; i += 3) {
-      // Get points
-      Coordinate* p0 = v[i];
-      Coordinate* p1 = v[i + 1];
-      Coordinate* p2 = v[i + 2];
-      Coordinate* p3 = v[i + 3];
-
-      // Column matrixes
-      Matrix x_vector({{p0->getX()}, {p1->getX()}, {p2->getX()}, {p3->getX()}});
-      Matrix y_vector({{p0->getY()}, {p1->getY()}, {p2->getY()}, {p3->getY()}});
-      Matrix z_vector({{p0->getZ()}, {p1->getZ()}, {p2->getZ()}, {p3->getZ()}});
-
-      while (temp_t <= 1) {
-        Matrix t_vec({Matrix::t_vector(temp_t)});  // Line matrix
-        Matrix t_mb = t_vec * mb;    // M(1,4) x M(4,4) = t_mb(1,4)
-
-        // M(1,4) x M(4,1) = M(1,1), so get line 0, column 0 to obtain the double value
-        double x = (t_mb * x_vector).getMatrix().at(0).at(0);
-        double y = (t_mb * y_vector).getMatrix().at(0).at(0);
-        double z = (t_mb * z_vector).getMatrix().at(0).at(0);
-
-        this->coordinateList.push_back(new Coordinate(x, y, z));
-        temp_t += t;
-      }
+  //! Appends the points of segment 'p' at t = 1/n, 2/n ... 1 (and 0 if 'first').
+  void appendSegment(const double p[4][3], int n, vector<double> &xyz, bool first) {
+    double h = 1.0 / n;
+    double h2 = h * h;
+    double h3 = h2 * h;
+
+    // Power basis a t^3 + b t^2 + c t + d, then its forward differences for step h
+    double f[3], d1[3], d2[3], d3[3];
+    for (int k = 0; k < 3; k++) {
+      double a = -p[0][k] + 3*p[1][k] - 3*p[2][k] + p[3][k];
+      double b = 3*p[0][k] - 6*p[1][k] + 3*p[2][k];
+      double c = -3*p[0][k] + 3*p[1][k];
+      f[k] = p[0][k];
+      d1[k] = a*h3 + b*h2 + c*h;
+      d2[k] = 6*a*h3 + 2*b*h2;
+      d3[k] = 6*a*h3;
+    }
 
-      temp_t = t;
+    xyz.reserve(xyz.size() + 3 * (n + 1));
+    if (first)
+      xyz.insert(xyz.end(), f, f + 3);
+
+    for (int i = 1; i < n; i++) {
+      for (int k = 0; k < 3; k++) {
+        f[k] += d1[k];
+        d1[k] += d2[k];
+        d2[k] += d3[k];
+      }
+      xyz.insert(xyz.end(), f, f + 3);
     }
 
+    // The end point exactly, without the rounding of the differences
+    xyz.insert(xyz.end(), p[3], p[3] + 3);
   }
 };
 
@@ -0,0 +1,72 @@
+#ifndef BOUNDINGBOX_HPP
+#define BOUNDINGBOX_HPP
+
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+//! An axis-aligned box in world coordinates.
+struct BoundingBox {
+  double min[3];
+  double max[3];
+
+  //! A box that contains nothing (merging anything into it gives that thing).
+  static BoundingBox empty() {
+    const double inf = numeric_limits<double>::infinity();
+    return {{inf, inf, inf}, {-inf, -inf, -inf}};
+  }
+
+  //! The cube of half side 'radius' around (x, y, z).
+  static BoundingBox around(double x, double y, double z, double radius) {
+    return {{x - radius, y - radius, z - radius}, {x + radius, y + radius, z + radius}};
+  }
+
+  void merge(const BoundingBox& o) {
+    for (int axis = 0; axis < 3; axis++) {
+      min[axis] = std::min(min[axis], o.min[axis]);
+      max[axis] = std::max(max[axis], o.max[axis]);
+    }
+  }
+
+  double center(int axis) const {
+    return (min[axis] + max[axis]) / 2;
+  }
+
+  //! The axis (0, 1 or 2) along which the box is the longest.
+  int longestAxis() const {
+    double dx = max[0] - min[0];
+    double dy = max[1] - min[1];
+    double dz = max[2] - min[2];
+    if (dx >= dy && dx >= dz)
+      return 0;
+    return (dy >= dz) ? 1 : 2;
+  }
+
+  //! One of the 8 corners, bit 0/1/2 of 'corner' chooses max along x/y/z.
+  void corner(int corner, double& x, double& y, double& z) const {
+    x = (corner & 1) ? max[0] : min[0];
+    y = (corner & 2) ? max[1] : min[1];
+    z = (corner & 4) ? max[2] : min[2];
+  }
+};
+
+//! An axis-aligned rectangle in normalized (window) coordinates.
+struct BoundingRect {
+  double minX, minY;
+  double maxX, maxY;
+
+  static BoundingRect empty() {
+    const double inf = numeric_limits<double>::infinity();
+    return {inf, inf, -inf, -inf};
+  }
+
+  void add(double x, double y) {
+    minX = std::min(minX, x);
+    minY = std::min(minY, y);
+    maxX = std::max(maxX, x);
+    maxY = std::max(maxY, y);
+  }
+};
+
+#endif  //!< BOUNDINGBOX_HPP
@@ -0,0 +1,182 @@
+#ifndef BOUNDINGVOLUMEHIERARCHY_HPP
+#define BOUNDINGVOLUMEHIERARCHY_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "boundingBox.hpp"
+#include "fixedMatrix.hpp"
+#include "graphicObject.hpp"
+
+using namespace std;
+
+#define BVH_LEAF_SIZE 4
+
+//! Culls the objects of the graphical world against the window.
+/*!
+ * A binary tree of world space boxes over the objects (@see
+ * GraphicObject::getBounds()). query() projects node boxes with the frame
+ * matrix and skips every subtree whose projection falls outside the
+ * normalized window, so objects out of view are never projected or clipped.
+ *
+ * Nodes cover contiguous runs of 'order', which holds object indexes, so a
+ * node fully inside the window accepts its objects without visiting children.
+ */
+class BoundingVolumeHierarchy {
+private:
+  struct Node {
+    BoundingBox box;
+    int parent;
+    int left, right;       //!< Children, -1 on leaves.
+    uint32_t first, count;  //!< Run of 'order' covered by the node.
+  };
+
+  vector<Node> nodes;
+  vector<uint32_t> order;         //!< Object indexes, grouped by node.
+  vector<BoundingBox> bounds;     //!< Box of each object.
+  vector<int> leafOf;             //!< Leaf of each object.
+  vector<int> stack;              //!< Traversal scratch, kept between queries.
+
+  //! Builds the subtree over order[first, first + count) and returns its node.
+  int build(uint32_t first, uint32_t count, int parent) {
+    int index = nodes.size();
+    nodes.push_back({BoundingBox::empty(), parent, -1, -1, first, count});
+
+    BoundingBox box = BoundingBox::empty();
+    BoundingBox centers = BoundingBox::empty();
+    for (uint32_t i = first; i < first + count; i++) {
+      const BoundingBox& b = bounds[order[i]];
+      box.merge(b);
+      centers.merge({{b.center(0), b.center(1), b.center(2)},
+                     {b.center(0), b.center(1), b.center(2)}});
+    }
+    nodes[index].box = box;
+
+    if (count <= BVH_LEAF_SIZE) {
+      for (uint32_t i = first; i < first + count; i++)
+        leafOf[order[i]] = index;
+      return index;
+    }
+
+    // Median split along the longest axis of the object centers
+    int axis = centers.longestAxis();
+    uint32_t half = count / 2;
+    nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count,
+        [this, axis](uint32_t a, uint32_t b) {
+          return bounds[a].center(axis) < bounds[b].center(axis);
+        });
+
+    int left = build(first, half, index);
+    int right = build(first + half, count - half, index);
+    nodes[index].left = left;
+    nodes[index].right = right;
+    return index;
+  }
+
+  enum Overlap { OUTSIDE, PARTIAL, INSIDE };
+
+  //! Where the projection of 'box' falls with respect to the normalized window.
+  static Overlap overlap(const BoundingBox& box, const Mat4& frame) {
+    double minX = 1e300, minY = 1e300, maxX = -1e300, maxY = -1e300;
+    int positive = 0;
+    for (int c = 0; c < 8; c++) {
+      double x, y, z;
+      box.corner(c, x, y, z);
+      Vec4 p = frame * Vec4::point(x, y, z);
+
+      // The image of the box is the hull of its corners' images only while
+      // the box does not cross the plane w = 0 (the center of projection)
+      if (p[3] == 0)
+        return PARTIAL;
+      if (p[3] > 0)
+        positive++;
+
+      minX = min(minX, p[0] / p[3]);
+      maxX = max(maxX, p[0] / p[3]);
+      minY = min(minY, p[1] / p[3]);
+      maxY = max(maxY, p[1] / p[3]);
+    }
+
+    if (positive != 0 && positive != 8)
+      return PARTIAL;
+
+    if (maxX < -1 || minX > 1 || maxY < -1 || minY > 1)
+      return OUTSIDE;
+    if (minX >= -1 && maxX <= 1 && minY >= -1 && maxY <= 1)
+      return INSIDE;
+    return PARTIAL;
+  }
+
+public:
+  //! Rebuilds the tree over 'objects' (indexes in 'objects' identify them).
+  void rebuild(const vector<GraphicObject*> &objects) {
+    nodes.clear();
+    order.resize(objects.size());
+    bounds.resize(objects.size());
+    leafOf.assign(objects.size(), -1);
+
+    for (uint32_t i = 0; i < objects.size(); i++) {
+      order[i] = i;
+      bounds[i] = objects[i]->getBounds();
+    }
+
+    if (!objects.empty())
+      build(0, objects.size(), -1);
+  }
+
+  //! Updates the boxes after the object 'index' moved or changed shape.
+  void refit(uint32_t index, GraphicObject* object) {
+    if (index >= bounds.size())
+      return;
+
+    bounds[index] = object->getBounds();
+
+    int node = leafOf[index];
+    Node& leaf = nodes[node];
+    leaf.box = BoundingBox::empty();
+    for (uint32_t i = leaf.first; i < leaf.first + leaf.count; i++)
+      leaf.box.merge(bounds[order[i]]);
+
+    for (node = leaf.parent; node != -1; node = nodes[node].parent) {
+      nodes[node].box = nodes[nodes[node].left].box;
+      nodes[node].box.merge(nodes[nodes[node].right].box);
+    }
+  }
+
+  //! Appends to 'visible' the indexes of the objects that may be inside the window.
+  /*!
+   * @param frame World to normalized coordinates matrix, without the camera
+   *    rotation (which cannot move an object out of its box).
+   */
+  void query(const Mat4& frame, vector<uint32_t> &visible) {
+    if (nodes.empty())
+      return;
+
+    stack.clear();
+    stack.push_back(0);
+    while (!stack.empty()) {
+      const Node& node = nodes[stack.back()];
+      stack.pop_back();
+
+      Overlap result = overlap(node.box, frame);
+      if (result == OUTSIDE)
+        continue;
+
+      if (result == INSIDE) {
+        visible.insert(visible.end(), order.begin() + node.first, order.begin() + node.first + node.count);
+      } else if (node.left == -1) {
+        for (uint32_t i = node.first; i < node.first + node.count; i++) {
+          if (overlap(bounds[order[i]], frame) != OUTSIDE)
+            visible.push_back(order[i]);
+        }
+      } else {
+        stack.push_back(node.right);
+        stack.push_back(node.left);
+      }
+    }
+  }
+
+};
+
+#endif  //!< BOUNDINGVOLUMEHIERARCHY_HPP
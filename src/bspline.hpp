@@ -6,28 +6,56 @@
 
 class BSpline : public Curve {
 public:
-  BSpline(string name) : Curve(name) {}
+  BSpline(string name) : Curve(name), delta(0) {
+    this->basis = BSPLINE;
+  }
+
+  //! @param delta Largest step of the parameter over each segment.
+  //! @param tolerance Largest distance allowed between the curve and its polyline.
+  BSpline(string name, const vector<Coordinate> &coordinateList, double delta, double tolerance)
+    : Curve(name) {
+        this->controlPoints = coordinateList;
+        this->basis = BSPLINE;
+        this->delta = delta;
+        Tessellation tessellation;
+        tessellate(tolerance, tessellation);
+        storeCoordinates(tessellation.xyz);
+        computeGeometricCenter();
+  }
 
-  BSpline(string name, vector<Coordinate*> &coordinateList, double delta)
-    : Curve(name, CURVE, coordinateList) {
-        this->create_points(coordinateList, delta);
+  double getDelta() {
+    return delta;
   }
 
 protected:
-  void create_points(vector<Coordinate*> &points, double delta) {
-    vector<Coordinate*> tmp;
+  double delta;
 
-    // 0 - Define delta, delta2, delta3 and n values
-    double delta2 = delta * delta;
-    double delta3 = delta2 * delta;
-    double n = 1/delta;
+  void tessellate(double tolerance, Tessellation &tessellation) override {
+    int minSteps = delta > 0 ? (int) min(ceil(1/delta), (double) TESSELLATION_MAX_STEPS) : 1;
+
+    // 0 - Define n for each segment. The second derivative of a segment
+    // goes from one second difference of its control points to the other.
+    vector<int> steps;
+    for (size_t i = 0; i + 3 < controlPoints.size(); i++) {
+      const Coordinate* c = &controlPoints[i];
+      steps.push_back(max(minSteps, LevelOfDetail::steps(LevelOfDetail::secondDifference(c[0], c[1], c[2], c[3]), tolerance)));
+    }
+    LevelOfDetail::limitSamples(steps, 1);
 
     // 1 - Compute coefficients
     Matrix mbs = Matrix::mbs();
-    Matrix e = Matrix::e(delta, delta2, delta3);
 
-    for (int i = 0; i <= points.size()-4; i++) {
-      vector<Coordinate*> control_points = {points[i], points[i+1], points[i+2], points[i+3]};
+    for (size_t i = 0; i + 3 < controlPoints.size(); i++) {
+      const Coordinate* c = &controlPoints[i];
+
+      // Define delta, delta2 and delta3
+      int n = steps[i];
+      double step = 1.0 / n;
+      double step2 = step * step;
+      double step3 = step2 * step;
+      Matrix e = Matrix::e(step, step2, step3);
+
+      vector<Coordinate> control_points = {c[0], c[1], c[2], c[3]};
       Matrix gx = Matrix::gx(control_points);
       Matrix gy = Matrix::gy(control_points);
       Matrix gz = Matrix::gz(control_points);
@@ -42,32 +70,29 @@ protected:
       Matrix d_z = e * c_z;
 
       // 3 - Call drawCurveFwdDiff
-      this->coordinateList = this->drawCurveFwdDiff(n, d_x.getMatrix()[0][0], d_x.getMatrix()[1][0], d_x.getMatrix()[2][0], d_x.getMatrix()[3][0]
+      this->drawCurveFwdDiff(tessellation.xyz, n, d_x.getMatrix()[0][0], d_x.getMatrix()[1][0], d_x.getMatrix()[2][0], d_x.getMatrix()[3][0]
                                                      , d_y.getMatrix()[0][0], d_y.getMatrix()[1][0], d_y.getMatrix()[2][0], d_y.getMatrix()[3][0]
                                                      , d_z.getMatrix()[0][0], d_z.getMatrix()[1][0], d_z.getMatrix()[2][0], d_z.getMatrix()[3][0]);
     }
   }
 
-  vector<Coordinate*> drawCurveFwdDiff(double n, double x, double dx, double d2x, double d3x, double y, double dy, double d2y, double d3y, double z, double dz, double d2z, double d3z) {
-    vector<Coordinate*> tmp;
+  //! Appends the points of a curve segment, from its forward differences, to 'xyz'.
+  void drawCurveFwdDiff(vector<double> &xyz, int n, double x, double dx, double d2x, double d3x, double y, double dy, double d2y, double d3y, double z, double dz, double d2z, double d3z) {
     int i = 0;
-    double x_old, y_old, z_old;
-    x_old = x;
-    y_old = y;
-    z_old = z;
-
-    tmp.push_back(new Coordinate(x_old, y_old, z_old));
+    xyz.reserve(xyz.size() + 3 * (n + 1));
+    xyz.push_back(x);
+    xyz.push_back(y);
+    xyz.push_back(z);
     while (i < n) {
       x = x + dx; dx = dx + d2x; d2x = d2x + d3x;
       y = y + dy; dy = dy + d2y; d2y = d2y + d3y;
       z = z + dz; dz = dz + d2z; d2z = d2z + d3z;
-      x_old = x; y_old = y; z_old = z;
 
-      tmp.push_back(new Coordinate(x_old, y_old, z_old));
+      xyz.push_back(x);
+      xyz.push_back(y);
+      xyz.push_back(z);
       i++;
     }
-
-    return tmp;
   }
 
 };
@@ -0,0 +1,161 @@
+#ifndef CAIROBACKEND_HPP
+#define CAIROBACKEND_HPP
+
+#include <gtk/gtk.h>
+#include <math.h>
+#include <mutex>
+
+#include "renderBackend.hpp"
+#include "scanlineFill.hpp"
+
+//! Renders with Cairo on offscreen image surfaces, double buffered.
+/*!
+ * Frames are drawn on the back surface, with a single cairo_t opened by
+ * clear() and released by flush(), which then swaps it with the front
+ * surface. present() only ever shows the front surface, the last complete
+ * frame, so frames can be rendered on another thread (@see RenderThread)
+ * while GTK repaints.
+ *
+ * resize() may be called from any thread: the front surface is replaced
+ * at once and the back one at the start of the next frame.
+ */
+class CairoBackend : public RenderBackend {
+private:
+  cairo_surface_t *front;  //!< Last complete frame, guarded by 'swapLock'.
+  cairo_surface_t *back;   //!< Frame being drawn.
+  cairo_t *frame;          //!< Context of the current frame, NULL between frames.
+  int backWidth, backHeight;
+  int width, height;       //!< Requested size, guarded by 'swapLock'.
+  mutex swapLock;
+  ScanlineFill scanline;
+
+  //! The context of the current frame, opened on demand.
+  cairo_t* context() {
+    if (!frame)
+      frame = cairo_create(back);
+    return frame;
+  }
+
+  static cairo_surface_t* blank(int width, int height) {
+    cairo_surface_t *surface = cairo_image_surface_create(CAIRO_FORMAT_RGB24, width, height);
+    cairo_t *cr = cairo_create(surface);
+    cairo_set_source_rgb (cr, 1, 1, 1);
+    cairo_paint (cr);
+    cairo_destroy(cr);
+    return surface;
+  }
+
+public:
+  CairoBackend() : front(NULL), back(NULL), frame(NULL), backWidth(0), backHeight(0),
+      width(0), height(0) {}
+
+  ~CairoBackend() {
+    if (frame)
+      cairo_destroy(frame);
+    if (back)
+      cairo_surface_destroy(back);
+    if (front)
+      cairo_surface_destroy(front);
+  }
+
+  void resize(int width, int height) {
+    lock_guard<mutex> guard(swapLock);
+    this->width = width;
+    this->height = height;
+
+    if (front)
+      cairo_surface_destroy(front);
+    front = blank(width, height);
+  }
+
+  void clear(double r, double g, double b) {
+    if (!frame) {
+      int width, height;
+      {
+        lock_guard<mutex> guard(swapLock);
+        width = this->width;
+        height = this->height;
+      }
+
+      if (!back || width != backWidth || height != backHeight) {
+        if (back)
+          cairo_surface_destroy(back);
+        back = cairo_image_surface_create(CAIRO_FORMAT_RGB24, width, height);
+        backWidth = width;
+        backHeight = height;
+      }
+    }
+
+    cairo_t *cr = context();
+    cairo_set_source_rgb (cr, r, g, b);
+    cairo_paint (cr);
+  }
+
+  void setColor(double r, double g, double b) {
+    cairo_set_source_rgb (context(), r, g, b);
+  }
+
+  //! Fills 'points' as pixel aligned spans (@see ScanlineFill).
+  /*!
+   * Cairo composites a path of pixel aligned rectangles without
+   * tessellating it, which is far cheaper than filling the polygon path.
+   */
+  void fillPolygon(PointSpan points) {
+    cairo_t *cr = context();
+    scanline.fill(points, backHeight,
+        [cr](int y, int x0, int x1) { cairo_rectangle(cr, x0, y, x1 - x0, 1); });
+    cairo_fill(cr);
+  }
+
+  void fillPoints(PointSpan points) {
+    cairo_t *cr = context();
+    for (size_t i = 0; i < points.size(); i++) {
+      cairo_new_sub_path(cr);
+      cairo_arc(cr, points[i].x, points[i].y, 1.0, 0.0, 2*M_PI);
+    }
+    cairo_fill(cr);
+  }
+
+  void strokePolylines(PointSpan points, const vector<size_t> &runs,
+      const vector<bool> &closed) {
+    cairo_t *cr = context();
+
+    size_t first = 0;
+    for (size_t run = 0; run < runs.size(); run++) {
+      cairo_move_to(cr, points[first].x, points[first].y);
+      for (size_t i = first + 1; i < first + runs[run]; i++) {
+        cairo_line_to(cr, points[i].x, points[i].y);
+      }
+      if (closed[run])
+        cairo_close_path(cr);
+      first += runs[run];
+    }
+    cairo_stroke(cr);
+  }
+
+  //! Finishes the frame and shows it, unless the size changed meanwhile.
+  void flush() {
+    if (!frame)
+      return;
+
+    cairo_destroy(frame);
+    frame = NULL;
+    cairo_surface_flush(back);
+
+    lock_guard<mutex> guard(swapLock);
+    if (backWidth == width && backHeight == height)
+      swap(front, back);
+  }
+
+  //! Paints the last complete frame on 'cr' (the GTK drawing area).
+  void present(cairo_t *cr) {
+    lock_guard<mutex> guard(swapLock);
+    if (!front)
+      return;
+
+    cairo_set_source_surface(cr, front, 0, 0);
+    cairo_paint(cr);
+  }
+};
+
+#endif  //!< CAIROBACKEND_HPP
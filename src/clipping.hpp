@@ -7,8 +7,12 @@
 #include <bitset>
 
 #include "curve.hpp"
+#include "frameArena.hpp"
+#include "lineBatchClipping.hpp"
 #include "line.hpp"
+#include "mesh3D.hpp"
 #include "polygon.hpp"
+#include "surface.hpp"
 
 #define LEFT 0
 #define RIGHT 1
@@ -19,11 +23,22 @@
 #define MINOUT 3
 #define MAXOUT 4
 #define BOTHOUT 5
+#define ACROSS 6
 
 
 class Clipping {
 private:
   vector<Coordinate*> wCoord;
+  SegmentBatch segmentBatch;  //!< Reused by object3DClipping().
+  vector<Vertex2D> polygonScratch[2];  //!< Ping-pong buffers of polygonClipping().
+  vector<Vertex2D> pointScratch;       //!< Clipped points, before they are copied to 'arena'.
+  vector<size_t> runScratch;           //!< Polylines of 'pointScratch' (@see surfaceClipping()).
+  FrameArena arena;                    //!< Holds the clipped points of the objects for a frame.
+
+  //! A copy of 'points' in 'arena'.
+  FrameSpan<Vertex2D> keep(PointSpan points) {
+    return arena.copy(points.begin(), points.size());
+  }
 
   const vector<Coordinate> clp {
 		  Coordinate(-1, -1),
@@ -42,64 +57,292 @@ public:
     delete this->wCoord.back();
   }
 
-  bool pointClipping(Coordinate* pointCoord) {
-    if (pointCoord->getXns() < wCoord.front()->getX() || pointCoord->getXns() > wCoord.back()->getX())
+  //! The arena the clipped points of the objects are written to.
+  /*!
+   * They stay valid until it is reset, which the caller does once the
+   * objects clipped since the last reset will not be drawn again.
+   */
+  FrameArena& getArena() {
+    return arena;
+  }
+
+  //! Checks if the vertex 'i' of the VertexBuffer is inside the window.
+  bool pointClipping(size_t i) {
+    VertexBuffer& buffer = VertexBuffer::scene();
+    if (buffer.getXns(i) < wCoord.front()->getX() || buffer.getXns(i) > wCoord.back()->getX())
       return false;
-    else if (pointCoord->getYns() < wCoord.front()->getY() || pointCoord->getYns() > wCoord.back()->getY())
+    else if (buffer.getYns(i) < wCoord.front()->getY() || buffer.getYns(i) > wCoord.back()->getY())
       return false;
     else
       return true;
   }
 
+  //! Where the normalized bounds of an object are with respect to the window.
+  /*!
+   * @return IN if the object is fully inside the window, OUT if it is fully
+   *    outside or ACROSS if it has to be clipped.
+   */
+  int windowOverlap(const BoundingRect& bounds) {
+    if (bounds.maxX < wCoord.front()->getX() || bounds.minX > wCoord.back()->getX()
+        || bounds.maxY < wCoord.front()->getY() || bounds.minY > wCoord.back()->getY())
+      return OUT;
+    if (bounds.minX >= wCoord.front()->getX() && bounds.maxX <= wCoord.back()->getX()
+        && bounds.minY >= wCoord.front()->getY() && bounds.maxY <= wCoord.back()->getY())
+      return IN;
+    return ACROSS;
+  }
+
+  //! The normalized coordinates of 'range', unclipped, in 'arena'.
+  FrameSpan<Vertex2D> windowPoints(VertexRange range) {
+    VertexBuffer& buffer = VertexBuffer::scene();
+    FrameSpan<Vertex2D> points = {arena.allocate<Vertex2D>(range.count), range.count};
+    for (size_t i = 0; i < range.count; i++) {
+      points[i] = {buffer.getXns(range.first + i), buffer.getYns(range.first + i)};
+    }
+    return points;
+  }
+
+  //! Copies the normalized coordinates of 'range', unclipped, to 'points'.
+  void copyWindowPoints(VertexRange range, vector<Vertex2D>& points) {
+    VertexBuffer& buffer = VertexBuffer::scene();
+    points.clear();
+    for (size_t i = range.first; i < range.end(); i++) {
+      points.push_back({buffer.getXns(i), buffer.getYns(i)});
+    }
+  }
+
+  bool lineClipping(Line* line, int chosenAlgorithm) {
+    switch (windowOverlap(line->getWindowBounds())) {
+      case IN:
+        return true;
+      case OUT:
+        return false;
+      default:
+        VertexRange vertices = line->getVertices();
+        return lineClipping(vertices.first, vertices.first + 1, chosenAlgorithm);
+    }
+  }
+
+  //! Clips all edges of the wireframe 'obj' at once (@see LineBatchClipping).
+  /*!
+   * @param edge Called as edge(i, a, b) to get the vertexes (relative to the
+   *    first one of 'obj') of the edge i.
+   * @return The visible parts, two points each; the normalized coordinates
+   *    of the vertices are left untouched.
+   */
+  template <typename EdgeFunction>
+  FrameSpan<Vertex2D> wireframeClipping(GraphicObject* obj, size_t edgeCount, EdgeFunction edge) {
+    VertexBuffer& buffer = VertexBuffer::scene();
+    FrameSpan<Vertex2D> out = {NULL, 0};
+
+    int overlap = windowOverlap(obj->getWindowBounds());
+    if (overlap == OUT) {
+      obj->setVisibility(false);
+      return out;
+    }
+
+    size_t base = obj->getVertices().first;
+    if (overlap == IN) {
+      out = {arena.allocate<Vertex2D>(2*edgeCount), 2*edgeCount};
+      for (size_t i = 0; i < edgeCount; i++) {
+        size_t a, b;
+        edge(i, a, b);
+        out[2*i] = {buffer.getXns(base + a), buffer.getYns(base + a)};
+        out[2*i + 1] = {buffer.getXns(base + b), buffer.getYns(base + b)};
+      }
+    } else {
+      segmentBatch.clear();
+      for (size_t i = 0; i < edgeCount; i++) {
+        size_t a, b;
+        edge(i, a, b);
+        segmentBatch.add(buffer.getXns(base + a), buffer.getYns(base + a),
+                         buffer.getXns(base + b), buffer.getYns(base + b));
+      }
+      pointScratch.clear();
+      LineBatchClipping::clip(segmentBatch, pointScratch);
+      out = keep(PointSpan::of(pointScratch));
+    }
+    obj->setVisibility(!out.empty());
+    return out;
+  }
+
+  void object3DClipping(Object3D* obj) {
+    const vector<Segment>& segments = obj->getSegmentList();
+    obj->setWindowSegments(wireframeClipping(obj, segments.size(), [&](size_t i, size_t& a, size_t& b) {
+      a = segments[i].getA();
+      b = segments[i].getB();
+    }));
+  }
+
+  //! Clips the edges of 'mesh'; each shared vertex was projected only once.
+  void mesh3DClipping(Mesh3D* mesh) {
+    const vector<uint32_t>& edges = mesh->getEdges();
+    mesh->setWindowSegments(wireframeClipping(mesh, mesh->edgeCount(), [&](size_t i, size_t& a, size_t& b) {
+      a = edges[2*i];
+      b = edges[2*i + 1];
+    }));
+  }
+
   void curveClipping(Curve* curve) {
-    curve->updateWindowPoints(curve->getCoordinates());
-    vector<Coordinate*> points = curve->getWindowPoints();
-    vector<Coordinate*> newPoints = {};
+    switch (windowOverlap(curve->getWindowBounds())) {
+      case IN:
+        curve->setWindowPoints(windowPoints(curve->getVertices()));
+        break;
+      case OUT:
+        curve->setWindowPoints({NULL, 0});
+        break;
+      default:
+        curveClipping(curve->getVertices(), pointScratch);
+        curve->setWindowPoints(keep(PointSpan::of(pointScratch)));
+    }
+    curve->setVisibility(!curve->getWindowPoints().empty());
+  }
 
-    for (int i = 0; i < points.size() - 1; ++i) {
-      Coordinate* c1 = points[i];
-      Coordinate* c2 = points[i+1];
+  //! Clips the rows and the columns of each sample grid of 'surface' as polylines.
+  void surfaceClipping(Surface* surface) {
+    vector<Vertex2D>& points = pointScratch;
+    vector<size_t>& runs = runScratch;
+    points.clear();
+    runs.clear();
+
+    int overlap = windowOverlap(surface->getWindowBounds());
+    if (overlap != OUT) {
+      for (const SampleGrid& grid : surface->getGrids()) {
+        for (size_t r = 0; r < grid.rows; r++) {
+          polylineClipping(grid.at(r, 0), 1, grid.columns, overlap == IN, points, runs);
+        }
+        for (size_t c = 0; c < grid.columns; c++) {
+          polylineClipping(grid.at(0, c), grid.columns, grid.rows, overlap == IN, points, runs);
+        }
+      }
+    }
+    surface->setWindowPolylines(keep(PointSpan::of(points)), arena.copy(runs.data(), runs.size()));
+    surface->setVisibility(!runs.empty());
+  }
+
+  //! Clips the polyline through 'count' vertices, 'stride' apart from vertex 'first'.
+  /*!
+   * Appends its visible parts to 'points', and the number of points of each
+   * one to 'runs': a polyline leaving and entering the window again is split.
+   * @param inside Whether the polyline is known to be inside the window.
+   */
+  void polylineClipping(size_t first, size_t stride, size_t count, bool inside,
+      vector<Vertex2D>& points, vector<size_t>& runs) {
+    VertexBuffer& buffer = VertexBuffer::scene();
+    size_t start = points.size();
+    auto endRun = [&]() {
+      if (points.size() - start > 1)
+        runs.push_back(points.size() - start);
+      else
+        points.resize(start);
+      start = points.size();
+    };
+
+    if (inside) {
+      for (size_t i = 0, v = first; i < count; i++, v += stride) {
+        points.push_back({buffer.getXns(v), buffer.getYns(v)});
+      }
+      endRun();
+      return;
+    }
+
+    // Whether the last point is the unclipped end of the previous segment
+    bool open = false;
+    for (size_t i = 0, v = first; i + 1 < count; i++, v += stride) {
+      Vertex2D a = {buffer.getXns(v), buffer.getYns(v)};
+      Vertex2D b = {buffer.getXns(v + stride), buffer.getYns(v + stride)};
+      Vertex2D aClipped = a;
+      Vertex2D bClipped = b;
+
+      if (!cohenSutherland(aClipped, bClipped)) {
+        endRun();
+        open = false;
+        continue;
+      }
+      if (!open || !equalPoints(a, aClipped)) {
+        endRun();
+        points.push_back(aClipped);
+      }
+      points.push_back(bClipped);
+      open = equalPoints(b, bClipped);
+    }
+    endRun();
+  }
+
+  //! Clips the curve whose points are 'range', writing the visible points in 'newPoints'.
+  void curveClipping(VertexRange range, vector<Vertex2D>& newPoints) {
+    VertexBuffer& buffer = VertexBuffer::scene();
+    newPoints.clear();
 
-      Coordinate* c1_copy = Coordinate::newWindowCoordinate(c1->getXns(), c1->getYns());
-      Coordinate* c2_copy = Coordinate::newWindowCoordinate(c2->getXns(), c2->getYns());
+    for (size_t i = range.first; i + 1 < range.end(); ++i) {
+      Vertex2D c1 = {buffer.getXns(i), buffer.getYns(i)};
+      Vertex2D c2 = {buffer.getXns(i+1), buffer.getYns(i+1)};
 
-      vector<Coordinate*> l = {c1_copy, c2_copy};
-      bool result = cohenSutherland(l);
+      Vertex2D c1_copy = c1;
+      Vertex2D c2_copy = c2;
+
+      bool result = cohenSutherland(c1_copy, c2_copy);
       if (result) {
         newPoints.push_back(c1_copy);
-        if (!equalPoints(*c2, *c2_copy)) {
+        // c2 starts the next segment, unless it was clipped or ends the curve
+        if (!equalPoints(c2, c2_copy) || i + 2 == range.end()) {
           newPoints.push_back(c2_copy);
         }
       }
-
-      curve->updateWindowPoints(newPoints);
     }
   }
 
-  bool equalPoints(Coordinate& c1, Coordinate& c2) {
-	   return (c1.getXns() == c2.getXns()) && (c1.getYns() == c2.getYns());
+  bool equalPoints(const Vertex2D& c1, const Vertex2D& c2) {
+	   return (c1.x == c2.x) && (c1.y == c2.y);
   }
 
   void polygonClipping(Polygon* polygon) {
-    polygon->updateWindowPoints(polygon->getCoordinates());
-    vector<Coordinate> clp = this->clp;
+    int overlap = windowOverlap(polygon->getWindowBounds());
+    if (overlap == OUT) {
+      polygon->setWindowPoints({NULL, 0});
+      polygon->setVisibility(false);
+      return;
+    }
+
+    if (overlap == IN)
+      polygon->setWindowPoints(windowPoints(polygon->getVertices()));
+    else
+      polygon->setWindowPoints(keep(polygonClipping(polygon->getVertices())));
+    polygon->setVisibility(!polygon->getWindowPoints().empty());
+  }
+
+  //! Sutherland-Hodgman clipping of the polygon whose vertices are 'range'.
+  /*!
+   * The four window edges are applied in turn, reading from one scratch
+   * buffer and writing to the other, so no memory is allocated once the
+   * buffers have grown to the largest polygon seen.
+   *
+   * @return The clipped polygon, valid until the next call.
+   */
+  PointSpan polygonClipping(VertexRange range) {
+    vector<Vertex2D>* points = &polygonScratch[0];
+    vector<Vertex2D>* new_points = &polygonScratch[1];
 
-    for (int i = 0; i < clp.size(); i++) {
+    copyWindowPoints(range, *points);
+    for (int i = 0; i < clp.size() && !points->empty(); i++) {
       int k = (i + 1) % clp.size();
-      Coordinate c1(clp[i]), c2(clp[k]);
-      clip(static_cast<Polygon&>(*polygon), c1, c2);
+      clip(*points, *new_points, clp[i], clp[k]);
+      swap(points, new_points);
     }
+
+    return PointSpan::of(*points);
   }
 
   //! Clips each edge of polygon over the window edge c1c2
   /**
-   * @param polygon The polygon being cliped
+   * @param points The polygon being cliped
+   * @param new_points Receives the clipped polygon
    * @param c1 A point of a window edge
    * @param c2 A point of a window edge (same edge as c1)
    */
-  void clip(Polygon& polygon, Coordinate& c1, Coordinate& c2) {
-    const vector<Coordinate*> points = polygon.getWindowPoints();
-    vector<Coordinate*> new_points;
+  void clip(const vector<Vertex2D>& points, vector<Vertex2D>& new_points,
+      const Coordinate& c1, const Coordinate& c2) {
+    new_points.clear();
     double x1 = c1.getX();
     double y1 = c1.getY();
     double x2 = c2.getX();
@@ -107,20 +350,11 @@ public:
 
     for (int i = 0; i < points.size(); i++) {
       int k = (i + 1) % points.size();
-      Coordinate* a = points[i];
-      Coordinate* b = points[k];
-
-      double ax = a->getXns();
-      double ay = a->getYns();
-      double bx = b->getXns();
-      double by = b->getYns();
-
-      double a_pos = (x2-x1)*(ay-y1) - (y2-y1)*(ax-x1);
-      double b_pos = (x2-x1)*(by-y1) - (y2-y1)*(bx-x1);
+      const Vertex2D& a = points[i];
+      const Vertex2D& b = points[k];
 
-      Coordinate* b_copy = new Coordinate(bx, by);
-      b_copy->setXns(b->getXns());
-      b_copy->setYns(b->getYns());
+      double a_pos = (x2-x1)*(a.y-y1) - (y2-y1)*(a.x-x1);
+      double b_pos = (x2-x1)*(b.y-y1) - (y2-y1)*(b.x-x1);
 
       /* Only second point is added */
       if (a_pos >= 0  && b_pos >= 0) {
@@ -142,19 +376,6 @@ public:
   		//no points are added
   	  }
     }
-
-    /* Updating polygon points */
-    if(new_points.size() == 0) {
-      /* Clear polygon window points */
-      for (int i = 0; i < points.size(); ++i) {
-        points.at(i)->setXns(0);
-        points.at(i)->setYns(0);
-      }
-      polygon.setVisibility(false);
-    } else {
-      polygon.updateWindowPoints(new_points);
-      polygon.setVisibility(true);
-    }
   }
 
   //! Calculates the intersection of the line segments p1p2 and p3p4.
@@ -162,19 +383,19 @@ public:
    * p1p2 is an edge of the window. p2p3 is a line segment which it wants the
    * intersection between it and p1p2.
    * @param point Indicates which Coordinate (p3 or p4) is outside the window.
-   * @return the point (Coordinate) of intersection.
+   * @return the point of intersection.
    */
-  Coordinate* intersection(Coordinate& p1, Coordinate& p2, Coordinate* p3,
-	  Coordinate* p4) {
+  Vertex2D intersection(const Coordinate& p1, const Coordinate& p2, const Vertex2D& p3,
+	  const Vertex2D& p4) {
     double x1 = p1.getX();
     double x2 = p2.getX();
-    double x3 = p3->getXns();
-    double x4 = p4->getXns();
+    double x3 = p3.x;
+    double x4 = p4.x;
 
     double y1 = p1.getY();
     double y2 = p2.getY();
-    double y3 = p3->getYns();
-    double y4 = p4->getYns();
+    double y3 = p3.y;
+    double y4 = p4.y;
 
     /* Resulting point */
     double x = 0;
@@ -186,20 +407,29 @@ public:
     y  = (x1*y2 - y1*x2)*(y3 - y4) - (y1 - y2)*(x3*y4 - y3*x4);
     y /= (x1 - x2)*(y3 - y4) - (y1 - y2)*(x3 - x4);
 
-    return Coordinate::newWindowCoordinate(x, y);
+    return {x, y};
   }
 
-  bool lineClipping(vector<Coordinate*> lineCoord, int chosenAlgorithm) {
+  //! Clips the line between the vertices 'a' and 'b', updating their normalized coordinates.
+  bool lineClipping(size_t a, size_t b, int chosenAlgorithm) {
+    VertexBuffer& buffer = VertexBuffer::scene();
+    Vertex2D coordMin = {buffer.getXns(a), buffer.getYns(a)};
+    Vertex2D coordMax = {buffer.getXns(b), buffer.getYns(b)};
+
+    bool visible;
     if (chosenAlgorithm == 1)
-      return cohenSutherland(lineCoord);
+      visible = cohenSutherland(coordMin, coordMax);
     else
-      return liangBarsky(lineCoord);
-  }
+      visible = liangBarsky(coordMin, coordMax);
 
-  bool cohenSutherland(vector<Coordinate*> lineCoord) {
-    Coordinate* coordMin = lineCoord.front();
-    Coordinate* coordMax = lineCoord.back();
+    if (visible) {
+      buffer.setNs(a, coordMin.x, coordMin.y);
+      buffer.setNs(b, coordMax.x, coordMax.y);
+    }
+    return visible;
+  }
 
+  bool cohenSutherland(Vertex2D& coordMin, Vertex2D& coordMax) {
     bitset<4> rgMin = generateRegionCode(coordMin);
     bitset<4> rgMax = generateRegionCode(coordMax);
 
@@ -211,8 +441,7 @@ public:
         return false;
       default:
         // Coefficient
-        double m = (coordMax->getYns() - coordMin->getYns())
-                        / (coordMax->getXns() - coordMin->getXns());
+        double m = (coordMax.y - coordMin.y) / (coordMax.x - coordMin.x);
 
         if (op == MINOUT) {
           computeNewCoordsCS(coordMin, rgMin, m);
@@ -236,16 +465,16 @@ public:
     }
   }
 
-  bitset<4> generateRegionCode(Coordinate* coord) {
+  bitset<4> generateRegionCode(const Vertex2D& coord) {
     bitset<4> rg(0000);
 
-    if (coord->getYns() > wCoord.back()->getY())
+    if (coord.y > wCoord.back()->getY())
       rg[TOP] = 1;
-    if (coord->getYns() < wCoord.front()->getY())
+    if (coord.y < wCoord.front()->getY())
       rg[BOTTOM] = 1;
-    if (coord->getXns() > wCoord.back()->getX())
+    if (coord.x > wCoord.back()->getX())
       rg[RIGHT] = 1;
-    if (coord->getXns() < wCoord.front()->getX())
+    if (coord.x < wCoord.front()->getX())
       rg[LEFT] = 1;
 
     return rg;
@@ -266,107 +495,83 @@ public:
     }
   }
 
-  void computeNewCoordsCS(Coordinate* coord, bitset<4> rg, double m) {
+  void computeNewCoordsCS(Vertex2D& coord, bitset<4> rg, double m) {
     if (rg[LEFT]) {
-      double y_xe = m * (wCoord.front()->getX() - coord->getXns()) + coord->getYns();
+      double y_xe = m * (wCoord.front()->getX() - coord.x) + coord.y;
 
       // Special case: Superior/inferior sides, when there are two active bits.
       // If change y is enough, stop. Otherwise go to the second active bit.
       if (y_xe >= wCoord.front()->getY() && y_xe <= wCoord.back()->getY()) {
-        coord->setYns(y_xe);
-        coord->setXns(wCoord.front()->getX());
+        coord.y = y_xe;
+        coord.x = wCoord.front()->getX();
         return;
       }
     }
     if (rg[RIGHT]) {
-      double y_xd = m * (wCoord.back()->getX() - coord->getXns()) + coord->getYns();
+      double y_xd = m * (wCoord.back()->getX() - coord.x) + coord.y;
 
       if (y_xd <= wCoord.back()->getY() && y_xd >= wCoord.front()->getY()) {
-        coord->setYns(y_xd);
-        coord->setXns(wCoord.back()->getX());
+        coord.y = y_xd;
+        coord.x = wCoord.back()->getX();
         return;
       }
     }
     if (rg[TOP]) {
-      double x_yt =  coord->getXns() + (1/m) * (wCoord.back()->getY() - coord->getYns());
+      double x_yt =  coord.x + (1/m) * (wCoord.back()->getY() - coord.y);
 
       if (x_yt <= wCoord.back()->getX() && x_yt >= wCoord.front()->getX()) {
-        coord->setXns(x_yt);
-        coord->setYns(wCoord.back()->getY());
+        coord.x = x_yt;
+        coord.y = wCoord.back()->getY();
         return;
       }
     }
     if (rg[BOTTOM]) {
-      double x_yf = coord->getXns() + (1/m) * (wCoord.front()->getY() - coord->getYns());
+      double x_yf = coord.x + (1/m) * (wCoord.front()->getY() - coord.y);
 
       if (x_yf >= wCoord.front()->getX() && x_yf <= wCoord.back()->getX()) {
-        coord->setXns(x_yf);
-        coord->setYns(wCoord.front()->getY());
+        coord.x = x_yf;
+        coord.y = wCoord.front()->getY();
         return;
       }
     }
   }
 
-  bool liangBarsky(vector<Coordinate*> lineCoord) {
-    Coordinate* coordMin = lineCoord.front();
-    Coordinate* coordMax = lineCoord.back();
-
-    double x0 = coordMin->getXns();
-    double y0 = coordMin->getYns();
-    double x1 = coordMax->getXns();
-    double y1 = coordMax->getYns();
+  bool liangBarsky(Vertex2D& coordMin, Vertex2D& coordMax) {
+    double x0 = coordMin.x;
+    double y0 = coordMin.y;
+    double x1 = coordMax.x;
+    double y1 = coordMax.y;
 
     double dX = (x1 - x0);
     double dY = (y1 - y0);
 
     /* `p` or `q` = [left, right, bottom, top] */
-    vector<double> p = {-dX, dX, -dY, dY};
-    vector<double> q = {x0+1, 1-x0, y0+1, 1-y0};
-
-    vector<double> negativeArr, positiveArr;
-    negativeArr.push_back(0);
-    positiveArr.push_back(1);
-
-    /* line parallel to and out of the view */
-    if ((p[0] == 0 && q[0] < 0) || (p[2] == 0 && q[2] < 0)) {
-      return false;
-    }
-
-    if (p[0] != 0) {
-      double r0 = q[0] / p[0];
-      double r1 = q[1] / p[1];
-      if (p[0] < 0) {
-        negativeArr.push_back(r0);
-        positiveArr.push_back(r1);
+    double p[4] = {-dX, dX, -dY, dY};
+    double q[4] = {x0+1, 1-x0, y0+1, 1-y0};
+
+    double rn0 = 0;
+    double rn1 = 1;
+    for (int k = 0; k < 4; k++) {
+      if (p[k] == 0) {
+        /* line parallel to and out of the view */
+        if (q[k] < 0)
+          return false;
+      } else if (p[k] < 0) {
+        rn0 = max(rn0, q[k] / p[k]);
       } else {
-        negativeArr.push_back(r1);
-        positiveArr.push_back(r0);
+        rn1 = min(rn1, q[k] / p[k]);
       }
     }
-    if (p[2] != 0) {
-      double r2 = q[2] / p[2];
-      double r3 = q[3] / p[3];
-      if (p[2] < 0) {
-        negativeArr.push_back(r2);
-        positiveArr.push_back(r3);
-      } else {
-        negativeArr.push_back(r3);
-        positiveArr.push_back(r2);
-      }
-    }
-
-    double rn0 = *std::max_element(std::begin(negativeArr), std::end(negativeArr));
-    double rn1 = *std::min_element(std::begin(positiveArr), std::end(positiveArr));
 
     if (rn0 > rn1) {
       return false;
     }
 
-    coordMin->setXns(x0 + p[1]*rn0);
-    coordMin->setYns(y0 + p[3]*rn0); // computing new points
+    coordMin.x = x0 + p[1]*rn0;
+    coordMin.y = y0 + p[3]*rn0; // computing new points
 
-    coordMax->setXns(x0 + p[1]*rn1);
-    coordMax->setYns(y0 + p[3]*rn1);
+    coordMax.x = x0 + p[1]*rn1;
+    coordMax.y = y0 + p[3]*rn1;
 
     return true;
   }
@@ -3,12 +3,12 @@
 
 #include <stdexcept>
 #include <iostream>
+#include <mutex>
 
 #include "bezierCurve.hpp"
 #include "bezierSurface.hpp"
 #include "bspline.hpp"
 #include "bsplineSurface.hpp"
-#include "clipping.hpp"
 #include "displayFile.hpp"
 #include "enum.hpp"
 #include "line.hpp"
@@ -17,6 +17,8 @@
 #include "object3D.hpp"
 #include "point.hpp"
 #include "polygon.hpp"
+#include "renderThread.hpp"
+#include "sceneFile.hpp"
 #include "view.hpp"
 
 /*! Representation of the Controller (or Control) module of the MVC (Model, View, Control) architecture */
@@ -25,15 +27,54 @@ class Controller {
 private:
   View view;
   DisplayFile display;
-  Clipping clipping;
-  vector<Coordinate*> pointsForPolygon;
-  vector<Coordinate*> pointsForCurve;
-  vector<vector<Coordinate*>> pointsForSurface;
-  vector<Segment*> segmentsForObject3D;
+  vector<Coordinate> pointsForPolygon;
+  vector<Coordinate> pointsForCurve;
+  vector<vector<Coordinate>> pointsForSurface;
+  vector<Coordinate> pointsForObject3D;  //!< Two points for each segment being added.
+  vector<GraphicObject*> visibleObjects;  //!< Objects not culled in the current frame.
   Coordinate cop = Coordinate(0, 0, -100);
+  size_t detailVersion = 0;  //!< Frame version the levels of detail were chosen for.
+
+  //! Guards the scene (objects, window, projection) against the render thread.
+  /*!
+   * Handlers hold it while they change anything the frames depend on;
+   * renderFrame() holds it while it reads the scene.
+   */
+  mutex sceneLock;
+  RenderThread renderThread;  //!< Declared last, so it is stopped first.
+
+  //! Renders a frame of the current scene (on 'renderThread').
+  void renderFrame() {
+    {
+      lock_guard<mutex> guard(sceneLock);
+      if (!view.hasWindow())
+        return;
+
+      view.beginDrawing();
+
+      // Camera, projection, SCN and viewport matrices are composed once per frame
+      view.beginFrame(&cop);
+
+      // Curves and surfaces follow the zoom: their tessellation depends on the frame
+      if (view.frameVersion() != detailVersion) {
+        detailVersion = view.frameVersion();
+        display.updateObjects([this](GraphicObject* obj) { return view.updateLevelOfDetail(obj); });
+      }
+
+      // Objects whose bounds fall outside the window are skipped altogether
+      visibleObjects.clear();
+      display.visibleObjects(view.frameMatrix(), visibleObjects);
+
+      view.render(visibleObjects);
+      view.drawViewPortArea();
+    }
+
+    // The Drawer keeps its own copy of the geometry: rasterize without the lock
+    view.endDrawing();
+  }
 
 public:
-  Controller() {
+  Controller() : renderThread([this] { renderFrame(); }) {
   }
 
   ~Controller() {
@@ -49,22 +90,23 @@ public:
    * GraphicObject and then sends this instance to 'view' to be drawn).
    */
   void createObject() {
+    lock_guard<mutex> guard(sceneLock);
     int currentPage = view.getCurrentPage();
     string name = view.getObjectName();
     string objType;
-    GraphicObject* obj;
+    GraphicObject* obj = NULL;
 
     switch (currentPage) {
      case POINT: {
-        vector<Coordinate*> pointCoordinate = {new Coordinate(view.getEntryPointX(), view.getEntryPointY(), view.getEntryPointZ())};
+        vector<Coordinate> pointCoordinate = {Coordinate(view.getEntryPointX(), view.getEntryPointY(), view.getEntryPointZ())};
         obj = new Point(name, pointCoordinate);
         objType = "PONTO";
 
         break;
      }
      case LINE: {
-        vector<Coordinate*> lineCoordinate = {new Coordinate(view.getEntryLineX1(), view.getEntryLineY1(), view.getEntryLineZ1()),
-                                               new Coordinate(view.getEntryLineX2(), view.getEntryLineY2(), view.getEntryLineZ2())};
+        vector<Coordinate> lineCoordinate = {Coordinate(view.getEntryLineX1(), view.getEntryLineY1(), view.getEntryLineZ1()),
+                                             Coordinate(view.getEntryLineX2(), view.getEntryLineY2(), view.getEntryLineZ2())};
         obj = new Line(name, lineCoordinate);
         objType = "LINHA";
 
@@ -93,9 +135,9 @@ public:
           }
 
           if (view.isCheckBtnSplineChecked()) {
-            obj = new BSpline(name, pointsForCurve, view.getDelta());
+            obj = new BSpline(name, pointsForCurve, view.getDelta(), view.curveTolerance());
           } else {
-            obj = new BezierCurve(name, pointsForCurve);
+            obj = new BezierCurve(name, pointsForCurve, view.curveTolerance());
           }
           objType = "CURVA";
 
@@ -108,10 +150,20 @@ public:
         break;
       }
       case OBJECT3D: {
-        obj = new Object3D(name, segmentsForObject3D);
+        if (pointsForObject3D.size() < 2) {
+          std::cout << "[ERROR] Cannot create a 3D object without at least one segment!" << std::endl;
+          view.logError("Pontos insuficientes para criação de objeto 3D.\n");
+          break;
+        }
+
+        vector<Segment> segments;
+        for (size_t i = 0; i + 1 < pointsForObject3D.size(); i += 2) {
+          segments.push_back(Segment(i, i + 1));
+        }
+        obj = new Object3D(name, pointsForObject3D, segments);
         objType = "OBJETO 3D";
 
-        segmentsForObject3D.clear();
+        pointsForObject3D.clear();
         view.clearObjet3DEntry();
         break;
       }
@@ -121,11 +173,17 @@ public:
             throw std::runtime_error(
                 "Cannot create a surface without at least 16 points!");
           }
+          for (const vector<Coordinate>& row : pointsForSurface) {
+            if (row.size() < 4) {
+              throw std::runtime_error(
+                  "Cannot create a surface with rows of less than 4 points!");
+            }
+          }
 
           if (view.isCheckBtnSplineSurfaceChecked()) {
-            obj = new BSplineSurface(name, pointsForSurface);
+            obj = new BSplineSurface(name, pointsForSurface, view.curveTolerance());
           } else {
-            obj = new BezierSurface(name, pointsForSurface);
+            obj = new BezierSurface(name, pointsForSurface, view.curveTolerance());
           }
           objType = "SUPERFICIE";
 
@@ -139,48 +197,72 @@ public:
       }
     }
 
-    display.insert(obj);
-    view.insertIntoListBox(*obj, objType);
+    if (obj == NULL)
+      return;
+
+    ObjectHandle handle = display.insert(obj);
+    view.insertIntoListBox(*obj, objType, handle);
     updateDrawScreen();
   }
 
   void createObjectsFromFile() {
     string fileName = view.chooseFile();
-    ObjDescriptor od;
-
-    vector<GraphicObject*> objs = od.read(fileName);
+    lock_guard<mutex> guard(sceneLock);
+
+    vector<GraphicObject*> objs;
+    if (SceneFile::handles(fileName)) {
+      SceneFile sf;
+      objs = sf.read(fileName);
+    } else {
+      ObjDescriptor od;
+      objs = od.read(fileName);
+    }
     for (int i = 0; i < objs.size(); ++i) {
-      display.insert(objs[i]);
-      showObjectIntoView(objs[i]);
+      showObjectIntoView(objs[i], display.insert(objs[i]));
     }
 
     updateDrawScreen();
   }
 
   void saveWorldToFile() {
+    lock_guard<mutex> guard(sceneLock);
     string fileName = view.getFileToSaveWorld();
 
-    ObjDescriptor od;
-    od.write(display.getObjs(), fileName);
+    if (SceneFile::handles(fileName)) {
+      SceneFile sf;
+      sf.write(display.getObjs(), fileName);
+    } else {
+      ObjDescriptor od;
+      od.write(display.getObjs(), fileName);
+    }
 
     view.clearSaveWorldFile();
   }
 
-  void showObjectIntoView(GraphicObject* gobj) {
+  void showObjectIntoView(GraphicObject* gobj, ObjectHandle handle) {
     switch (gobj->getType()) {
       case POINT:
-        view.insertIntoListBox(*gobj, "PONTO");
+        view.insertIntoListBox(*gobj, "PONTO", handle);
         break;
       case LINE:
-        view.insertIntoListBox(*gobj, "LINHA");
+        view.insertIntoListBox(*gobj, "LINHA", handle);
         break;
       case POLYGON:
-        view.insertIntoListBox(*gobj, "POLIGONO");
+        view.insertIntoListBox(*gobj, "POLIGONO", handle);
         pointsForPolygon.clear();
         break;
+      case CURVE:
+        view.insertIntoListBox(*gobj, "CURVA", handle);
+        break;
      case OBJECT3D:
-        view.insertIntoListBox(*gobj, "OBJ_3D");
-        segmentsForObject3D.clear();
+        view.insertIntoListBox(*gobj, "OBJ_3D", handle);
+        pointsForObject3D.clear();
+        break;
+     case MESH3D:
+        view.insertIntoListBox(*gobj, "MALHA", handle);
+        break;
+     case SURFACE:
+        view.insertIntoListBox(*gobj, "SUPERFICIE", handle);
         break;
     }
   }
@@ -190,30 +272,27 @@ public:
    * Takes the selected object in the object list and applies a transformation.
    */
   void executeObjectTransformation() {
+    lock_guard<mutex> guard(sceneLock);
     int currentPage = view.getCurrentPageTransformation();
-    int currentObjectIndex = view.getCurrentObjectIndex();
-    GraphicObject* obj = display.getElementoNoIndice(currentObjectIndex);
+    ObjectHandle handle = view.getSelectedObject();
+    GraphicObject* obj = display.get(handle);
+    if (obj == NULL) {
+      view.logError("Nenhum objeto selecionado!\n");
+      return;
+    }
 
     switch (currentPage) {
       case TRANSLATION: {
         Coordinate translationVector(view.getEntryTranslationX(), view.getEntryTranslationY(), view.getEntryTranslationZ());
 
-        if (obj->getType() != OBJECT3D && obj->getType() != SURFACE) {
-          ObjectTransformation::translation(static_cast<GraphicObject2D*>(obj)->getCoordinates(), &translationVector);
-        } else {
-          ObjectTransformation::translation(static_cast<Object3D*>(obj)->getAllCoord(), &translationVector);
-        }
+        ObjectTransformation::translation(obj, &translationVector);
         break;
       }
       case SCALING: {
         Coordinate scalingVector(view.getEntryScalingX(), view.getEntryScalingY(), view.getEntryScalingZ());
         Coordinate objCenter = obj->getGeometricCenter();
 
-        if (obj->getType() != OBJECT3D && obj->getType() != SURFACE) {
-          ObjectTransformation::scaling(static_cast<GraphicObject2D*>(obj)->getCoordinates(), &objCenter, &scalingVector);
-        } else {
-          ObjectTransformation::scaling(static_cast<Object3D*>(obj)->getAllCoord(), &objCenter, &scalingVector);
-        }
+        ObjectTransformation::scaling(obj, &objCenter, &scalingVector);
         break;
       }
       case ROTATION: {
@@ -231,17 +310,15 @@ public:
           reference = new Coordinate(view.getEntryRotationX(), view.getEntryRotationY(), view.getEntryRotationZ());
         }
 
-        if (obj->getType() != OBJECT3D && obj->getType() != SURFACE) {
-          ObjectTransformation::rotation(static_cast<GraphicObject2D*>(obj)->getCoordinates(), angle, reference, whichAxis);
-        } else {
-          ObjectTransformation::rotation(static_cast<Object3D*>(obj)->getAllCoord(), angle, reference, whichAxis);
-        }
+        ObjectTransformation::rotation(obj, angle, reference, whichAxis);
 
         delete reference;
         break;
       }
     }
 
+    view.updateLevelOfDetail(obj);
+    display.refit(handle);
     updateDrawScreen();
   }
 
@@ -255,6 +332,7 @@ public:
 
   void create_surface(GtkWidget *widget) {
     view.create_surface(widget);
+    updateDrawScreen();
   }
 
   void draw(cairo_t *cr) {
@@ -262,14 +340,17 @@ public:
   }
 
   void initializeWindowViewPort() {
-    view.initializeWindowViewPort();
+    {
+      lock_guard<mutex> guard(sceneLock);
+      view.initializeWindowViewPort();
+    }
+    updateDrawScreen();
   }
 
   //! Calls View::removeSelectedObject() and updates the screen with updateDrawScreen().
   void removeSelectedObject() {
-    int index = view.removeFromList(view.getListObj());
-
-    display.remove(index);
+    lock_guard<mutex> guard(sceneLock);
+    display.remove(view.removeSelectedObject());
     updateDrawScreen();
   }
 
@@ -301,7 +382,7 @@ public:
     int index = view.removeFromList(view.getListSegment());
 
     if (index > -1) {
-        segmentsForObject3D.erase(segmentsForObject3D.begin() + index);
+        pointsForObject3D.erase(pointsForObject3D.begin() + 2*index, pointsForObject3D.begin() + 2*index + 2);
     }
   }
 
@@ -313,9 +394,7 @@ public:
     double x = view.getEntryPolygonX();
     double y = view.getEntryPolygonY();
     double z = view.getEntryPolygonZ();
-    Coordinate* c = new Coordinate(x, y, z);
-
-    pointsForPolygon.push_back(c);
+    pointsForPolygon.push_back(Coordinate(x, y, z));
     view.insertCoordList(view.getListCoordPolygon(), x, y, z);
   }
 
@@ -327,9 +406,7 @@ public:
     double x = view.getEntryCurveX();
     double y = view.getEntryCurveY();
     double z = view.getEntryCurveZ();
-    Coordinate* c = new Coordinate(x, y, z);
-
-    pointsForCurve.push_back(c);
+    pointsForCurve.push_back(Coordinate(x, y, z));
     view.insertCoordList(view.getListCoordCurve(), x, y, z);
   }
 
@@ -351,42 +428,14 @@ public:
     Coordinate* c3 = new Coordinate(0,60,30);
     Coordinate* c4 = new Coordinate(0,100,0);
     */
-    Coordinate* c1 = new Coordinate(0,0,0);
-    Coordinate* c2 = new Coordinate(0,30,40);
-    Coordinate* c3 = new Coordinate(0,60,30);
-    Coordinate* c4 = new Coordinate(0,100,0);
-    vector<Coordinate*> v1;
-    v1.push_back(c1);
-    v1.push_back(c2);
-    v1.push_back(c3);
-    v1.push_back(c4);
-    Coordinate* c5 = new Coordinate(30,25,20);
-    Coordinate* c6 = new Coordinate(20,60,50);
-    Coordinate* c7 = new Coordinate(30,80,50);
-    Coordinate* c8 = new Coordinate(40,0,20);
-    vector<Coordinate*> v2;
-    v2.push_back(c5);
-    v2.push_back(c6);
-    v2.push_back(c7);
-    v2.push_back(c8);
-    Coordinate* c9 = new Coordinate(60,30,20);
-    Coordinate* c10 = new Coordinate(80,60,50);
-    Coordinate* c11 = new Coordinate(70,100,45);
-    Coordinate* c12 = new Coordinate(60,0,25);
-    vector<Coordinate*> v3;
-    v3.push_back(c9);
-    v3.push_back(c10);
-    v3.push_back(c11);
-    v3.push_back(c12);
-    Coordinate* c13 = new Coordinate(100,0,1);
-    Coordinate* c14 = new Coordinate(110,30,40);
-    Coordinate* c15 = new Coordinate(110,60,30);
-    Coordinate* c16 = new Coordinate(100,90,1);
-    vector<Coordinate*> v4;
-    v4.push_back(c13);
-    v4.push_back(c14);
-    v4.push_back(c15);
-    v4.push_back(c16);
+    vector<Coordinate> v1 = {Coordinate(0,0,0), Coordinate(0,30,40),
+                             Coordinate(0,60,30), Coordinate(0,100,0)};
+    vector<Coordinate> v2 = {Coordinate(30,25,20), Coordinate(20,60,50),
+                             Coordinate(30,80,50), Coordinate(40,0,20)};
+    vector<Coordinate> v3 = {Coordinate(60,30,20), Coordinate(80,60,50),
+                             Coordinate(70,100,45), Coordinate(60,0,25)};
+    vector<Coordinate> v4 = {Coordinate(100,0,1), Coordinate(110,30,40),
+                             Coordinate(110,60,30), Coordinate(100,90,1)};
 
     pointsForSurface.push_back(v1);
     pointsForSurface.push_back(v2);
@@ -402,11 +451,8 @@ public:
     double y2 = view.getEntry3DY2();
     double z2 = view.getEntry3DZ2();
 
-    Coordinate* a = new Coordinate(x1, y1, z1);
-    Coordinate* b = new Coordinate(x2, y2, z2);
-    Segment* s = new Segment(a, b);
-
-    segmentsForObject3D.push_back(s);
+    pointsForObject3D.push_back(Coordinate(x1, y1, z1));
+    pointsForObject3D.push_back(Coordinate(x2, y2, z2));
     view.insertCoordList(view.getListSegment(), x1, y1, z1, x2, y2, z2);
   }
 
@@ -415,6 +461,7 @@ public:
    * @param op The operation to be done on the Window (@see View::updateWindow()).
    */
   void changeWindow(int op) {
+    lock_guard<mutex> guard(sceneLock);
     try {
       view.updateWindow(view.getStep(), op);
     } catch (int e) {
@@ -423,34 +470,6 @@ public:
     updateDrawScreen();
   }
 
-  void rotateCamera(GraphicObject* element) {
-      Window* window = view.getWindow();
-
-      double angleX = window->getAngleX();
-      double angleY = window->getAngleY();
-      double angleZ = window->getAngleZ();
-
-      Coordinate geoCenter = element->getGeometricCenter();
-
-      if (element->getType() != OBJECT3D && element->getType() != SURFACE) {
-        ObjectTransformation::cameraRotation(
-            static_cast<GraphicObject2D*>(element)->getCoordinates(),
-            &geoCenter,
-            angleX,
-            angleY,
-            angleZ
-        );
-      } else {
-        ObjectTransformation::cameraRotation(
-            static_cast<Object3D*>(element)->getAllCoord(),
-            &geoCenter,
-            angleX,
-            angleY,
-            angleZ
-        );
-      }
-  }
-
   void updateObjRotateBtnState(int newState) {
     view.updateObjRotateBtnState(newState);
   }
@@ -460,7 +479,9 @@ public:
   }
 
   void updateClippingRadioBtnState(int newState) {
+    lock_guard<mutex> guard(sceneLock);
     view.updateClippingRadioBtnState(newState);
+    updateDrawScreen();
   }
 
   void updateCheckBtnState() {
@@ -476,107 +497,32 @@ public:
   }
 
   void updateProjectionState(int newState) {
+    lock_guard<mutex> guard(sceneLock);
     view.updateProjectionBtnState(newState);
     updateDrawScreen();
   }
 
   void updateCOP() {
+    lock_guard<mutex> guard(sceneLock);
     cop.setZ(-view.getNewCOP());
     updateDrawScreen();
   }
 
   void updateWindowAngle(int whichAxis) {
+    lock_guard<mutex> guard(sceneLock);
     double angle = view.getAngleRotateWindow();
 
     view.updateWindow(angle, whichAxis);
     updateDrawScreen();
   }
 
-  //! Calls 'view' to (re)drawn all elements in 'displayFile'.
+  //! Asks for all elements in 'displayFile' to be (re)drawn.
+  /*!
+   * Returns at once: the frame is rendered by 'renderThread', and requests
+   * made while it is busy are merged into one frame of the latest scene.
+   */
   void updateDrawScreen() {
-    view.clear_surface();
-
-    // Step 1 and 2 (Both projections) - Translate COP and compute θx e θy
-    view.computeAngleForProjection(&cop);
-
-    Elemento<GraphicObject*>* nextElement = display.getHead();
-    while (nextElement != NULL) {
-      GraphicObject* element = nextElement->getInfo();
-
-      rotateCamera(element);
-
-      view.transformProjection(element, &cop);
-      view.transformSCN(element);
-
-      switch (element->getType()) {
-        case POINT: {
-          Point* point = static_cast<Point*>(element);
-
-          if (clipping.pointClipping(point->getCoordinates()[0])) {
-            view.transform(point);
-            view.drawNewPoint(point);
-          }
-          break;
-        }
-        case LINE: {
-          Line* line = static_cast<Line*>(element);
-
-          if (clipping.lineClipping(line->getCoordinates(), view.getLineClippingAlgorithm())) {
-            view.transform(line);
-            view.drawNewLine(line);
-          }
-          break;
-        }
-        case POLYGON: { // TODO Fix visibility
-          Polygon* polygon = static_cast<Polygon*>(element);
-
-          clipping.polygonClipping(polygon);
-          if (polygon->isVisible()) {
-            view.transform(polygon);
-            view.drawNewPolygon(polygon, polygon->fill());
-          }
-          break;
-        }
-        case CURVE: { // TODO Fix visibility
-          Curve* curve = static_cast<Curve*>(element);
-
-          clipping.curveClipping(curve);
-          if (curve->isVisible()) {
-            view.transform(curve);
-            view.drawNewCurve(curve);
-          }
-          break;
-        }
-        case OBJECT3D: { // TODO Fix visibility
-          Object3D* obj3D = static_cast<Object3D*>(element);
-
-          vector<Segment*> segments = obj3D->getSegmentList();
-          vector<Segment*>::iterator segment;
-          for(segment = segments.begin(); segment != segments.end(); segment++) {
-              vector<Coordinate*> tmp = (*segment)->getCoordinates();
-              (*segment)->setVisibility(clipping.lineClipping(tmp, 1));
-          }
-
-          view.transform(obj3D);
-          view.drawNewObject3D(obj3D);
-
-          break;
-        }
-        case SURFACE: {
-          Surface* surface = static_cast<Surface*>(element);
-          vector<Curve*> curves = surface->getCurves();
-          vector<Curve*>::iterator c;
-          for(c = curves.begin(); c != curves.end(); ++c) {
-              clipping.curveClipping(*c);
-              view.transform(*c);
-              view.drawNewCurve(*c);
-          }
-          break;
-        }
-      }
-      nextElement = nextElement->getProximo();
-    }
-    view.drawViewPortArea();
+    renderThread.request();
   }
 
 };
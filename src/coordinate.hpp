@@ -11,10 +11,6 @@ private:
   double xop; /*! Orthogonal projection coordinates. */
   double yop;
   double zop;
-  double xvp; /*! ViewPort coordinates. */
-  double yvp;
-  double xns; /*! Window coordinates. */
-  double yns;
 
 public:
   Coordinate(double x, double y, double z = 1) {
@@ -37,7 +33,7 @@ public:
     this->z = z;
   }
 
-  double get(const int axis) {
+  double get(const int axis) const {
     switch(axis) {
       case 0: return this->getX();
       case 1: return this->getY();
@@ -82,45 +78,6 @@ public:
     this->zop = zop;
   }
 
-  void setXvp(double x) {
-    this->xvp = x;
-  }
-
-  void setYvp(double y) {
-    this->yvp = y;
-  }
-
-  double getXvp() const {
-    return this->xvp;
-  }
-
-  double getYvp() const {
-    return this->yvp;
-  }
-
-  double getXns() {
-    return this->xns;
-  }
-
-  double getYns() {
-    return this->yns;
-  }
-
-  void setXns(double xns) {
-    this->xns = xns;
-  }
-
-  void setYns(double yns) {
-    this->yns = yns;
-  }
-
-  static Coordinate* newWindowCoordinate(double x, double y) {
-    Coordinate* w = new Coordinate(0, 0);
-    w->setXns(x);
-    w->setYns(y);
-    return w;
-  }
-
 };
 
 #endif  //!< COORDINATE_HPP
@@ -2,6 +2,7 @@
 #define CURVE_HPP
 
 #include "graphicObject2D.hpp"
+#include "levelOfDetail.hpp"
 
 using namespace std;
 
@@ -9,50 +10,67 @@ using namespace std;
 
 class Curve: public GraphicObject2D {
 protected:
-	vector<Coordinate*> windowPoints;
-  bool visibility;
+	FrameSpan<Vertex2D> windowPoints;  //!< The curve clipped against the window, for the current frame.
+  vector<Coordinate> controlPoints;  //!< None if the curve is just its points (e.g. read from a file).
+  Basis basis;                       //!< TESSELLATED if there are no control points.
+  TessellationCache tessellations;
+
+  //! Tessellates the control points into a polyline within 'tolerance' (world units) of the curve.
+  virtual void tessellate(double tolerance, Tessellation &tessellation) {}
 
 public:
-  Curve(string name) : GraphicObject2D(name, CURVE) {
-    this->windowPoints = {};
-    this->visibility = true;
-  }
+  Curve(string name) : GraphicObject2D(name, CURVE), windowPoints{NULL, 0}, basis(TESSELLATED) {}
 
-  Curve(string name,  Type type, vector<Coordinate*> &coordinateList) :
-      GraphicObject2D(name, type, coordinateList) {
-    this->windowPoints = {};
-    this->visibility = true;
-  }
+  Curve(string name,  Type type, const vector<Coordinate> &coordinateList) :
+      GraphicObject2D(name, type, coordinateList), windowPoints{NULL, 0}, basis(TESSELLATED) {}
 
-  ~Curve() {
-    vector<Coordinate*>::iterator it;
-    for(it = coordinateList.begin(); it != coordinateList.end(); it++) {
-	  delete *it;
-    }
-  }
+  //! A curve already tessellated into 'points'.
+  Curve(string name, CoordinateSpan points) :
+      GraphicObject2D(name, CURVE, points), windowPoints{NULL, 0}, basis(TESSELLATED) {}
 
-  void setVisibility(bool updateVisibility) {
-    this->visibility = updateVisibility;
+  FrameSpan<Vertex2D> getWindowPoints() {
+    return windowPoints;
   }
 
-  bool isVisible() {
-    return this->visibility;
+  void setWindowPoints(FrameSpan<Vertex2D> points) {
+    windowPoints = points;
   }
 
-  vector<Coordinate*> getWindowPoints() {
-    return windowPoints;
+  const vector<Coordinate>& getControlPoints() {
+    return controlPoints;
   }
 
-  void addCoordinate(Coordinate* c) {
-    this->coordinateList.push_back(c);
+  Basis getBasis() {
+    return basis;
   }
 
-  void updateCoordinateList(vector<Coordinate*> v) {
-    this->coordinateList = v;
+  //! Shows the curve at level of detail 'level' (@see LevelOfDetail).
+  /*!
+   * @return false if the points of the curve did not change.
+   */
+  bool setLevel(int level) {
+    if (controlPoints.empty())
+      return false;
+
+    const Tessellation* tessellation = tessellations.select(level,
+        [this](double tolerance, Tessellation &t) { tessellate(tolerance, t); });
+    if (tessellation == NULL)
+      return false;
+
+    storeCoordinates(tessellation->xyz);
+    return true;
   }
 
-  void updateWindowPoints(vector<Coordinate*> newPoints) {
-    this->windowPoints = newPoints;
+  //! Transforms the control points along with the points of the curve.
+  void transform(const Mat4& transformation) override {
+    GraphicObject2D::transform(transformation);
+    for (Coordinate& point : controlPoints) {
+      Vec4 p = transformation * Vec4::point(point.getX(), point.getY(), point.getZ());
+      point = Coordinate(p[0], p[1], p[2]);
+    }
+
+    // Scaling changes the error of the tessellations: setLevel() redoes them
+    tessellations.clear();
   }
 
 };
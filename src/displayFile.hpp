@@ -1,37 +1,157 @@
 #ifndef DISPLAYFILE_HPP
 #define DISPLAYFILE_HPP
 
-#include "listEnc.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "boundingVolumeHierarchy.hpp"
 #include "graphicObject.hpp"
 
+using namespace std;
+
+//! Identifies an object of the DisplayFile (@see DisplayFile::insert()).
+/*!
+ * A handle stays valid while its object is in the DisplayFile, even if other
+ * objects are inserted or removed. Once the object is removed, the slot
+ * generation changes and the handle no longer finds anything.
+ */
+struct ObjectHandle {
+	uint32_t slot;
+	uint32_t generation;  //!< 0 is never a valid generation.
+};
+
+//! The objects of the graphical world.
+/*!
+ * A slot map: objects are kept contiguous in 'objects', in insertion
+ * order, and 'slots' maps each handle to its current position in 'objects'.
+ * That order is the paint order, so removing an object keeps the order of
+ * the others (@see remove()).
+ */
 class DisplayFile {
 private:
-	ListaEnc<GraphicObject*>* displayFile;
+	struct Slot {
+		uint32_t dense;       //!< Position of the object in 'objects'.
+		uint32_t generation;  //!< Incremented each time the slot is released.
+	};
+
+	vector<GraphicObject*> objects;
+	vector<uint32_t> denseToSlot;  //!< Slot of each position of 'objects'.
+	vector<Slot> slots;
+	vector<uint32_t> freeSlots;
+
+	BoundingVolumeHierarchy index;  //!< Over 'objects', rebuilt lazily after insert/remove.
+	bool indexStale;
+	vector<uint32_t> visibleScratch;
 
 public:
 
-	DisplayFile () {
-		displayFile = new ListaEnc<GraphicObject*>();
+	DisplayFile () : indexStale(false) {}
+
+	~DisplayFile() {
+		for (GraphicObject* obj : objects)
+			delete obj;
+	}
+
+	//! Appends 'x' and returns the handle that identifies it.
+	ObjectHandle insert(GraphicObject* x) {
+		uint32_t slot;
+		if (freeSlots.empty()) {
+			slot = slots.size();
+			slots.push_back({0, 1});
+		} else {
+			slot = freeSlots.back();
+			freeSlots.pop_back();
+		}
+
+		slots[slot].dense = objects.size();
+		objects.push_back(x);
+		denseToSlot.push_back(slot);
+		indexStale = true;
+
+		return {slot, slots[slot].generation};
 	}
 
-	Elemento<GraphicObject*>* getHead() {
-		return displayFile->getHead();
+	bool contains(ObjectHandle handle) const {
+		return handle.slot < slots.size() && handle.generation != 0
+			&& slots[handle.slot].generation == handle.generation;
 	}
 
-	void insert(GraphicObject* x) {
-		displayFile->adiciona(x);
+	//! The object of 'handle', or NULL if it was removed.
+	GraphicObject* get(ObjectHandle handle) const {
+		if (!contains(handle))
+			return NULL;
+		return objects[slots[handle.slot].dense];
 	}
 
-	void remove(int index) {
-		delete displayFile->retiraDaPosicao(index);
+	//! Deletes the object of 'handle', shifting the objects after it one position back.
+	void remove(ObjectHandle handle) {
+		if (!contains(handle))
+			return;
+
+		uint32_t dense = slots[handle.slot].dense;
+		delete objects[dense];
+
+		objects.erase(objects.begin() + dense);
+		denseToSlot.erase(denseToSlot.begin() + dense);
+		for (uint32_t i = dense; i < denseToSlot.size(); i++) {
+			slots[denseToSlot[i]].dense = i;
+		}
+
+		slots[handle.slot].generation++;
+		if (slots[handle.slot].generation == 0)
+			slots[handle.slot].generation = 1;
+		freeSlots.push_back(handle.slot);
+		indexStale = true;
+	}
+
+	//! Updates the spatial index after the object of 'handle' was transformed.
+	void refit(ObjectHandle handle) {
+		if (!contains(handle) || indexStale)
+			return;
+
+		uint32_t dense = slots[handle.slot].dense;
+		index.refit(dense, objects[dense]);
+	}
+
+	//! Calls 'update' on every object, refitting the spatial index for those it changed.
+	/*!
+	 * @param update Returns true if it changed the vertices of the object.
+	 */
+	template<typename Update>
+	void updateObjects(Update update) {
+		for (uint32_t dense = 0; dense < objects.size(); dense++) {
+			if (update(objects[dense]) && !indexStale)
+				index.refit(dense, objects[dense]);
+		}
+	}
+
+	//! Appends to 'visible' the objects that may be seen through 'frame', in display file order.
+	/*!
+	 * @param frame World to normalized coordinates matrix of the frame
+	 *    (@see ViewPipeline::getProjection()).
+	 */
+	void visibleObjects(const Mat4& frame, vector<GraphicObject*> &visible) {
+		if (indexStale) {
+			index.rebuild(objects);
+			indexStale = false;
+		}
+
+		visibleScratch.clear();
+		index.query(frame, visibleScratch);
+
+		// In display file order, not that of the index: it is the paint order
+		sort(visibleScratch.begin(), visibleScratch.end());
+		for (uint32_t dense : visibleScratch)
+			visible.push_back(objects[dense]);
 	}
 
-	ListaEnc<GraphicObject*>* getObjs() {
-		return displayFile;
+	size_t size() const {
+		return objects.size();
 	}
 
-	GraphicObject* getElementoNoIndice(int index) {
-		return displayFile->elementoNoIndice(index);
+	const vector<GraphicObject*>& getObjs() const {
+		return objects;
 	}
 
 };
@@ -1,106 +1,141 @@
 #ifndef DRAWER_HPP
 #define DRAWER_HPP
 
-#include <math.h>
-
 #include "graphicObject.hpp"
-
-static cairo_surface_t *surface = NULL;
-
+#include "renderBackend.hpp"
+
+//! Draws the objects shown by the viewport through a RenderBackend.
+/*!
+ * Drawing happens in frames (@see beginFrame()). Points and every line,
+ * curve and polygon outline are accumulated and submitted as one batch of
+ * points and one batch of polylines, either before the next filled polygon
+ * or in endFrame(): objects are still painted in the order they are drawn,
+ * and a filled polygon covers whatever came before it.
+ */
 class Drawer {
-public:
-	Drawer() {}
-	~Drawer() {}
+private:
+	RenderBackend* backend;
+	bool drawing;  //!< Whether a frame is open.
+
+	vector<Vertex2D> strokePoints;  //!< Polylines of the frame, back to back.
+	vector<size_t> strokeRuns;      //!< Number of points of each polyline.
+	vector<bool> strokeClosed;      //!< Whether each polyline is closed.
+	vector<Vertex2D> pointMarks;    //!< Points of the frame.
+
+	bool viewPortPending;           //!< Border requested during the frame.
+	double viewPortX, viewPortY;
+	int viewPortMargin;
+
+	void addPolyline(PointSpan points, bool closed) {
+		strokePoints.insert(strokePoints.end(), points.begin(), points.end());
+		strokeRuns.push_back(points.size());
+		strokeClosed.push_back(closed);
+	}
 
-	void clear_surface () {
-	  cairo_t *cr = cairo_create (surface);
+	//! Submits the points and polylines accumulated since the last fill.
+	void submitStrokes() {
+		if (!pointMarks.empty())
+			backend->fillPoints(PointSpan::of(pointMarks));
+		if (!strokeRuns.empty())
+			backend->strokePolylines(PointSpan::of(strokePoints), strokeRuns, strokeClosed);
+
+		strokePoints.clear();
+		strokeRuns.clear();
+		strokeClosed.clear();
+		pointMarks.clear();
+	}
 
-	  cairo_set_source_rgb (cr, 1, 1, 1);
-	  cairo_paint (cr);
+	void strokeViewPortArea(double x, double y, int margin) {
+		Vertex2D border[4] = {{(double) margin, (double) margin}, {x, (double) margin},
+		                      {x, y}, {(double) margin, y}};
+		backend->setColor(1, 0, 0);
+		backend->strokePolylines({border, 4}, vector<size_t>(1, 4), vector<bool>(1, true));
+	}
 
-	  cairo_destroy (cr);
+public:
+	//! @param backend Where the frames are rendered, owned by the Drawer.
+	Drawer(RenderBackend* backend) : backend(backend), drawing(false), viewPortPending(false) {}
+	~Drawer() {
+		delete backend;
 	}
 
-	void create_surface(GtkWidget* widget) {
-	  if (surface)
-	    cairo_surface_destroy(surface);
+	RenderBackend* getBackend() {
+		return backend;
+	}
 
-	  surface = gdk_window_create_similar_surface(gtk_widget_get_window(widget),
-	              CAIRO_CONTENT_COLOR, gtk_widget_get_allocated_width(widget)-10,
-	              gtk_widget_get_allocated_height(widget)-10);
-	  clear_surface();
+	//! Opens a new frame and clears the surface.
+	void beginFrame() {
+		backend->clear(1, 1, 1);
+		backend->setColor(0, 0, 0);
+		drawing = true;
+
+		strokePoints.clear();
+		strokeRuns.clear();
+		strokeClosed.clear();
+		pointMarks.clear();
+		viewPortPending = false;
 	}
 
-	void drawViewPortArea(Coordinate* vpcoord, int margin) {
-		cairo_t *cr = cairo_create (surface);
-		cairo_set_source_rgb (cr, 1, 0, 0);
+	//! Submits the accumulated geometry and finishes the frame.
+	void endFrame() {
+		if (!drawing)
+			return;
 
-		cairo_move_to(cr, margin, margin);
-		cairo_line_to(cr, vpcoord->getX(), margin);
-		cairo_line_to(cr, vpcoord->getX(), vpcoord->getY());
-		cairo_line_to(cr, margin, vpcoord->getY());
-		cairo_close_path(cr);
+		submitStrokes();
 
-		cairo_stroke(cr);
-	}
+		if (viewPortPending)
+			strokeViewPortArea(viewPortX, viewPortY, viewPortMargin);
 
-	void draw(cairo_t *cr) {
-		cairo_set_source_surface(cr, surface, 0, 0);
-		cairo_paint(cr);
+		backend->flush();
+		drawing = false;
 	}
 
-	void drawPoint(Coordinate* coord) {
-		cairo_t *c = cairo_create (surface);
+	//! Draws the border of the viewport over the objects of the current frame.
+	void drawViewPortArea(Coordinate* vpcoord, int margin) {
+		if (!drawing)
+			return;
 
-		cairo_move_to(c, coord->getXvp(), coord->getYvp());
-		cairo_arc(c, coord->getXvp(), coord->getYvp(), 1.0, 0.0, 2*M_PI);
-		cairo_fill(c);
+		viewPortPending = true;
+		viewPortX = vpcoord->getX();
+		viewPortY = vpcoord->getY();
+		viewPortMargin = margin;
+	}
 
-		cairo_stroke(c);
+	void drawPoint(double x, double y) {
+		pointMarks.push_back({x, y});
 	}
 
-	void drawLine(Coordinate* coordIn, Coordinate* coordFin) {
-		// TODO Specific when X and Y == 0, maybe change that to an operator== in coordinate?
-		if (coordIn->getXvp() == coordFin->getXvp() && coordIn->getYvp() == coordFin->getYvp()) {
-			drawPoint(coordIn);
+	void drawLine(double x0, double y0, double x1, double y1) {
+		if (x0 == x1 && y0 == y1) {
+			drawPoint(x0, y0);
 			return;
 		}
 
-		cairo_t* crl = cairo_create (surface);
-
-		cairo_move_to(crl, coordIn->getXvp(), coordIn->getYvp());
-		cairo_line_to(crl, coordFin->getXvp(), coordFin->getYvp());
-		cairo_stroke(crl);
+		Vertex2D line[2] = {{x0, y0}, {x1, y1}};
+		addPolyline({line, 2}, false);
 	}
 
-	void drawPolygon(vector<Coordinate*> polygonPoints, bool fill) {
-		cairo_t* cr = cairo_create (surface);
-		int end = polygonPoints.size();
-
-		cairo_move_to(cr, polygonPoints[0]->getXvp(), polygonPoints[0]->getYvp());
+	void drawPolygon(PointSpan polygonPoints, bool fill) {
+		if (polygonPoints.size() == 0)
+			return;
 
-		// Draws polygon's edges two by two points. The last edge is the segment
-		// polygonPoints[end]|polygonPoints[0].
-		for (int i = 1; i < end; i++) {
-			cairo_line_to(cr, polygonPoints[i]->getXvp(), polygonPoints[i]->getYvp());
+		if (!fill) {
+			addPolyline(polygonPoints, true);
+			return;
 		}
 
-		cairo_close_path(cr);
-		if (fill)
-			cairo_fill(cr);
-
-		cairo_stroke(cr);
+		// Each polygon is filled on its own: overlapping polygons in one path
+		// could cancel each other out under the winding rule. What was drawn
+		// before goes first, so the fill covers it.
+		submitStrokes();
+		backend->fillPolygon(polygonPoints);
 	}
 
-	void drawCurve(vector<Coordinate*> curvePoints) {
-		cairo_t* cr = cairo_create (surface);
-		int end = curvePoints.size();
-
-		for (int i = 0; i < end-1; i++) {
-		    drawLine(curvePoints[i], curvePoints[i+1]);
-		}
-
-		cairo_stroke(cr);
+	void drawCurve(PointSpan curvePoints) {
+		if (curvePoints.size() == 1)
+			drawPoint(curvePoints[0].x, curvePoints[0].y);
+		else if (curvePoints.size() > 1)
+			addPolyline(curvePoints, false);
 	}
 
 };
@@ -1,7 +1,8 @@
 #ifndef TIPO_HPP
 #define TIPO_HPP
 
-enum Type {POINT, LINE, POLYGON, CURVE, OBJECT3D, SURFACE, WINDOW};
+enum Type {POINT, LINE, POLYGON, CURVE, OBJECT3D, SURFACE, WINDOW, MESH3D};
+enum Basis {TESSELLATED, BEZIER, BSPLINE};  //!< What the control points of a curve or surface mean.
 enum Transformation {TRANSLATION, SCALING, ROTATION};
 
 #endif
@@ -0,0 +1,258 @@
+#ifndef FIXEDMATRIX_HPP
+#define FIXEDMATRIX_HPP
+
+#include <math.h>
+
+/*! Fixed-size vectors and matrices stored inline (no heap allocation).
+ *
+ * Vec4/Mat4 work on homogeneous 3D coordinates and Vec3/Mat3 on homogeneous
+ * 2D coordinates. Products follow the same convention as Matrix: a matrix
+ * times a column vector, so `A * B * p` applies B first and then A.
+ */
+
+struct Vec3 {
+  double v[3];
+
+  static constexpr Vec3 point(double x, double y) {
+    return {{x, y, 1}};
+  }
+
+  constexpr double operator[](int i) const {
+    return v[i];
+  }
+
+  constexpr double& operator[](int i) {
+    return v[i];
+  }
+};
+
+struct alignas(32) Vec4 {
+  double v[4];
+
+  static constexpr Vec4 point(double x, double y, double z) {
+    return {{x, y, z, 1}};
+  }
+
+  constexpr double operator[](int i) const {
+    return v[i];
+  }
+
+  constexpr double& operator[](int i) {
+    return v[i];
+  }
+
+  constexpr double dot(const Vec4& o) const {
+    return v[0]*o.v[0] + v[1]*o.v[1] + v[2]*o.v[2] + v[3]*o.v[3];
+  }
+};
+
+struct alignas(32) Mat3 {
+  double m[3][3];
+
+  static constexpr Mat3 identity() {
+    return {{{1, 0, 0},
+             {0, 1, 0},
+             {0, 0, 1}}};
+  }
+
+  //! Translation by (x, y).
+  static constexpr Mat3 translation(double x, double y) {
+    return {{{1, 0, x},
+             {0, 1, y},
+             {0, 0, 1}}};
+  }
+
+  //! Scaling by (x, y) around the origin.
+  static constexpr Mat3 scaling(double x, double y) {
+    return {{{x, 0, 0},
+             {0, y, 0},
+             {0, 0, 1}}};
+  }
+
+  //! Rotation of 'angle' radians around the origin.
+  static Mat3 rotation(double angle) {
+    return {{{cos(angle), -sin(angle), 0},
+             {sin(angle),  cos(angle), 0},
+             {    0     ,      0     , 1}}};
+  }
+
+  constexpr Mat3 transpose() const {
+    Mat3 r{};
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 3; j++)
+        r.m[i][j] = m[j][i];
+    return r;
+  }
+
+  constexpr Mat3 operator* (const Mat3& o) const {
+    Mat3 r{};
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 3; j++)
+        r.m[i][j] = m[i][0]*o.m[0][j] + m[i][1]*o.m[1][j] + m[i][2]*o.m[2][j];
+    return r;
+  }
+
+  constexpr bool operator== (const Mat3& o) const {
+    for (int i = 0; i < 3; i++)
+      for (int j = 0; j < 3; j++)
+        if (m[i][j] != o.m[i][j])
+          return false;
+    return true;
+  }
+
+  constexpr Vec3 operator* (const Vec3& p) const {
+    return {{m[0][0]*p.v[0] + m[0][1]*p.v[1] + m[0][2]*p.v[2],
+             m[1][0]*p.v[0] + m[1][1]*p.v[1] + m[1][2]*p.v[2],
+             m[2][0]*p.v[0] + m[2][1]*p.v[1] + m[2][2]*p.v[2]}};
+  }
+};
+
+struct alignas(64) Mat4 {
+  double m[4][4];
+
+  static constexpr Mat4 identity() {
+    return {{{1, 0, 0, 0},
+             {0, 1, 0, 0},
+             {0, 0, 1, 0},
+             {0, 0, 0, 1}}};
+  }
+
+  //! Translation by (x, y, z).
+  static constexpr Mat4 translation(double x, double y, double z) {
+    return {{{1, 0, 0, x},
+             {0, 1, 0, y},
+             {0, 0, 1, z},
+             {0, 0, 0, 1}}};
+  }
+
+  //! Scaling by (x, y, z) around the origin.
+  static constexpr Mat4 scaling(double x, double y, double z) {
+    return {{{x, 0, 0, 0},
+             {0, y, 0, 0},
+             {0, 0, z, 0},
+             {0, 0, 0, 1}}};
+  }
+
+  //! Rotation of 'angle' radians around the X axis.
+  static Mat4 rotationX(double angle) {
+    return {{{1,    0      ,     0      , 0},
+             {0, cos(angle), -sin(angle), 0},
+             {0, sin(angle),  cos(angle), 0},
+             {0,    0      ,     0      , 1}}};
+  }
+
+  //! Rotation of 'angle' radians around the Y axis.
+  static Mat4 rotationY(double angle) {
+    return {{{ cos(angle), 0, sin(angle), 0},
+             {    0      , 1,      0    , 0},
+             {-sin(angle), 0, cos(angle), 0},
+             {    0      , 0,      0    , 1}}};
+  }
+
+  //! Rotation of 'angle' radians around the Z axis.
+  static Mat4 rotationZ(double angle) {
+    return {{{cos(angle), -sin(angle), 0, 0},
+             {sin(angle),  cos(angle), 0, 0},
+             {    0     ,     0      , 1, 0},
+             {    0     ,     0      , 0, 1}}};
+  }
+
+  static constexpr Mat4 genericRotationAlpha(double cy, double cz, double d) {
+    return {{{1,   0  ,   0  , 0},
+             {0,  cz/d, -cy/d, 0},
+             {0,  cy/d,  cz/d, 0},
+             {0,   0  ,   0  , 1}}};
+  }
+
+  static constexpr Mat4 genericRotationBeta(double cx, double d) {
+    return {{{ d, -cx, 0, 0},
+             {cx,  d , 0, 0},
+             { 0,  0 , 1, 0},
+             { 0,  0 , 0, 1}}};
+  }
+
+  //! Bezier basis matrix (same as Matrix::mb()).
+  static constexpr Mat4 mb() {
+    return {{{-1.0,  3.0, -3.0, 1.0},
+             { 3.0, -6.0,  3.0, 0.0},
+             {-3.0,  3.0,  0.0, 0.0},
+             { 1.0,  0.0,  0.0, 0.0}}};
+  }
+
+  //! B-Spline basis matrix (same as Matrix::mbs()).
+  static constexpr Mat4 mbs() {
+    return {{{-1.0/6,  3.0/6, -3.0/6, 1.0/6},
+             { 3.0/6, -6.0/6,  3.0/6,  0.0 },
+             {-3.0/6,   0.0 ,  3.0/6,  0.0 },
+             { 1.0/6,  4.0/6,  1.0/6,  0.0 }}};
+  }
+
+  //! Forward differences matrix (same as Matrix::e()).
+  static constexpr Mat4 e(double delta, double delta2, double delta3) {
+    return {{{   0.0   ,    0.0   ,  0.0 , 1.0},
+             {  delta3 ,   delta2 , delta, 0.0},
+             { 6*delta3,  2*delta2,  0.0 , 0.0},
+             { 6*delta3,    0.0   ,  0.0 , 0.0}}};
+  }
+
+  //! Same as Matrix::t_matrix().
+  static constexpr Mat4 tMatrix(double tee) {
+    return {{{    0     ,      0    ,  0 , 1},
+             {tee*tee*tee,   tee*tee, tee, 0},
+             {6*tee*tee*tee, 2*tee*tee, 0, 0},
+             {6*tee*tee*tee,    0    ,  0, 0}}};
+  }
+
+  //! Same as Matrix::t_matrixt().
+  static constexpr Mat4 tMatrixT(double tee) {
+    return tMatrix(tee).transpose();
+  }
+
+  constexpr Mat4 transpose() const {
+    Mat4 r{};
+    for (int i = 0; i < 4; i++)
+      for (int j = 0; j < 4; j++)
+        r.m[i][j] = m[j][i];
+    return r;
+  }
+
+  constexpr Mat4 operator* (const Mat4& o) const {
+    Mat4 r{};
+    for (int i = 0; i < 4; i++)
+      for (int j = 0; j < 4; j++)
+        r.m[i][j] = m[i][0]*o.m[0][j] + m[i][1]*o.m[1][j]
+                  + m[i][2]*o.m[2][j] + m[i][3]*o.m[3][j];
+    return r;
+  }
+
+  constexpr bool operator== (const Mat4& o) const {
+    for (int i = 0; i < 4; i++)
+      for (int j = 0; j < 4; j++)
+        if (m[i][j] != o.m[i][j])
+          return false;
+    return true;
+  }
+
+  //! Matrix times a column vector.
+  constexpr Vec4 operator* (const Vec4& p) const {
+    return {{m[0][0]*p.v[0] + m[0][1]*p.v[1] + m[0][2]*p.v[2] + m[0][3]*p.v[3],
+             m[1][0]*p.v[0] + m[1][1]*p.v[1] + m[1][2]*p.v[2] + m[1][3]*p.v[3],
+             m[2][0]*p.v[0] + m[2][1]*p.v[1] + m[2][2]*p.v[2] + m[2][3]*p.v[3],
+             m[3][0]*p.v[0] + m[3][1]*p.v[1] + m[3][2]*p.v[2] + m[3][3]*p.v[3]}};
+  }
+};
+
+//! Row vector times a matrix (e.g. `tVector(t) * Mat4::mb()`).
+constexpr Vec4 operator* (const Vec4& p, const Mat4& a) {
+  return {{p.v[0]*a.m[0][0] + p.v[1]*a.m[1][0] + p.v[2]*a.m[2][0] + p.v[3]*a.m[3][0],
+           p.v[0]*a.m[0][1] + p.v[1]*a.m[1][1] + p.v[2]*a.m[2][1] + p.v[3]*a.m[3][1],
+           p.v[0]*a.m[0][2] + p.v[1]*a.m[1][2] + p.v[2]*a.m[2][2] + p.v[3]*a.m[3][2],
+           p.v[0]*a.m[0][3] + p.v[1]*a.m[1][3] + p.v[2]*a.m[2][3] + p.v[3]*a.m[3][3]}};
+}
+
+//! [t³ t² t 1], same as Matrix::t_vector().
+constexpr Vec4 tVector(double tee) {
+  return {{tee * tee * tee, tee * tee, tee, 1}};
+}
+
+#endif  //!< FIXEDMATRIX_HPP
@@ -0,0 +1,96 @@
+#ifndef FRAMEARENA_HPP
+#define FRAMEARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+#define FRAME_ARENA_BLOCK_SIZE (64 << 10)  //!< Bytes of the first block of a FrameArena.
+
+//! 'count' elements allocated from a FrameArena, valid until it is reset.
+template<typename T>
+struct FrameSpan {
+  T* data;
+  size_t count;
+
+  size_t size() const { return count; }
+  bool empty() const { return count == 0; }
+  T* begin() const { return data; }
+  T* end() const { return data + count; }
+  T& operator[](size_t i) const { return data[i]; }
+};
+
+//! A bump allocator for the geometry computed during a frame.
+/*!
+ * Allocating moves a pointer forward in the current block; when it is full
+ * a block twice as large is added. reset() releases everything at once and,
+ * if the frame needed more than one block, replaces them with one block of
+ * their total size, so later frames of the same size allocate nothing from
+ * the system.
+ */
+class FrameArena {
+private:
+  vector<unique_ptr<char[]> > blocks;
+  vector<size_t> sizes;  //!< Bytes of each block.
+  size_t used;           //!< Bytes taken from the last block.
+  size_t total;          //!< Bytes taken since the last reset, in all blocks.
+
+  void addBlock(size_t size) {
+    blocks.emplace_back(new char[size]);
+    sizes.push_back(size);
+    used = 0;
+  }
+
+public:
+  FrameArena() : used(0), total(0) {}
+
+  //! Bytes allocated since the last reset().
+  size_t allocated() const {
+    return total;
+  }
+
+  //! Uninitialized room for 'count' elements of T.
+  template<typename T>
+  T* allocate(size_t count) {
+    size_t bytes = count * sizeof(T);
+    size_t start = (used + alignof(T) - 1) & ~(alignof(T) - 1);
+    if (blocks.empty() || start + bytes > sizes.back()) {
+      size_t size = blocks.empty() ? FRAME_ARENA_BLOCK_SIZE : 2 * sizes.back();
+      addBlock(max(size, bytes));
+      start = 0;
+    }
+
+    used = start + bytes;
+    total += bytes;
+    return reinterpret_cast<T*>(blocks.back().get() + start);
+  }
+
+  //! A copy of the 'count' elements of 'items' (T must be trivially copyable).
+  template<typename T>
+  FrameSpan<T> copy(const T* items, size_t count) {
+    FrameSpan<T> span = {allocate<T>(count), count};
+    if (count > 0)
+      memcpy(span.data, items, count * sizeof(T));
+    return span;
+  }
+
+  //! Releases everything allocated, invalidating every FrameSpan from this arena.
+  void reset() {
+    if (blocks.size() > 1) {
+      size_t size = 0;
+      for (size_t s : sizes)
+        size += s;
+      blocks.clear();
+      sizes.clear();
+      addBlock(size);
+    }
+    used = 0;
+    total = 0;
+  }
+};
+
+#endif  //!< FRAMEARENA_HPP
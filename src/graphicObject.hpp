@@ -1,10 +1,14 @@
 #ifndef GRAPHICOBJECT_HPP
 #define GRAPHICOBJECT_HPP
 
+#include <string>
 #include <vector>
 
+#include "boundingBox.hpp"
 #include "coordinate.hpp"
 #include "enum.hpp"
+#include "frameArena.hpp"
+#include "vertexBuffer.hpp"
 
 using namespace std;
 
@@ -15,16 +19,46 @@ protected:
 	string name;
 	Type type;
 	double cx, cy, cz;
+	VertexRange vertices;  //!< The vertices of the object in VertexBuffer::scene().
+	bool visibility;
+	size_t cacheVersion;   //!< Version of the cached projection (@see SceneRenderer::render()), 0 when dirty.
+	BoundingRect windowBounds;  //!< Bounds of the normalized coordinates (@see View::project()).
+
+	//! Replaces the vertices of the object with 'coordinates'.
+	void storeCoordinates(const vector<Coordinate> &coordinates) {
+		VertexBuffer::scene().release(vertices);
+		vertices = VertexBuffer::scene().store(coordinates);
+		markDirty();
+	}
+
+	//! Replaces the vertices of the object with 'xyz' (@see VertexBuffer::store()).
+	void storeCoordinates(const vector<double> &xyz) {
+		VertexBuffer::scene().release(vertices);
+		vertices = VertexBuffer::scene().store(xyz);
+		markDirty();
+	}
+
+	//! Replaces the vertices of the object with 'coordinates'.
+	void storeCoordinates(CoordinateSpan coordinates) {
+		VertexBuffer::scene().release(vertices);
+		vertices = VertexBuffer::scene().store(coordinates);
+		markDirty();
+	}
 
 public:
-  GraphicObject(string name_) : name(name_) {}
+  GraphicObject(string name_) : name(name_), vertices{0, 0}, visibility(true), cacheVersion(0),
+      windowBounds(BoundingRect::empty()) {}
 
-	GraphicObject(string name,  Type type) {
+	GraphicObject(string name,  Type type) : vertices{0, 0}, visibility(true), cacheVersion(0),
+      windowBounds(BoundingRect::empty()) {
 		this->name = name;
 		this->type = type;
 	}
 
-	~GraphicObject() {}
+	//! Gives the vertices back to the VertexBuffer; objects are deleted through base pointers.
+	virtual ~GraphicObject() {
+		VertexBuffer::scene().release(vertices);
+	}
 
 	string getObjectName() {
 		return this->name;
@@ -34,12 +68,68 @@ public:
 		return this->type;
 	}
 
+	VertexRange getVertices() {
+		return this->vertices;
+	}
+
+	void setVisibility(bool updateVisibility) {
+		this->visibility = updateVisibility;
+	}
+
+	bool isVisible() {
+		return this->visibility;
+	}
+
+	const BoundingRect& getWindowBounds() {
+		return this->windowBounds;
+	}
+
+	void setWindowBounds(const BoundingRect& bounds) {
+		this->windowBounds = bounds;
+	}
+
+	//! Drops the cached projection, the object changed in the world.
+	void markDirty() {
+		this->cacheVersion = 0;
+	}
+
+	//! Checks if the projected and clipped points were computed for 'version'.
+	bool isCached(size_t version) {
+		return this->cacheVersion == version;
+	}
+
+	void setCacheVersion(size_t version) {
+		this->cacheVersion = version;
+	}
+
 	Coordinate getGeometricCenter() {
 		computeGeometricCenter();
 		return Coordinate(cx, cy, cz);
 	}
 
-	virtual void computeGeometricCenter()=0;
+	//! A box containing the object for any camera rotation.
+	/*!
+	 * The camera rotates each object around its geometric center, so the box
+	 * bounds the sphere around that center reaching the farthest vertex.
+	 */
+	BoundingBox getBounds() {
+		computeGeometricCenter();
+		double radius = VertexBuffer::scene().radius(vertices, Coordinate(cx, cy, cz));
+		return BoundingBox::around(cx, cy, cz, radius);
+	}
+
+	//! Applies 'transformation' to the world coordinates of the object.
+	virtual void transform(const Mat4& transformation) {
+		VertexBuffer::scene().transform(vertices, transformation);
+		markDirty();
+	}
+
+	virtual void computeGeometricCenter() {
+		Coordinate center = VertexBuffer::scene().center(vertices);
+		cx = center.getX();
+		cy = center.getY();
+		cz = center.getZ();
+	}
 };
 
 #endif
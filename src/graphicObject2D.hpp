@@ -8,42 +8,19 @@ using namespace std;
 /*! The generic type of an graphical object (point, line, polygon, etc) */
 
 class GraphicObject2D: public GraphicObject {
-protected:
-	vector<Coordinate*> coordinateList;
-
 public:
   GraphicObject2D(string name, Type type) : GraphicObject(name, type) {}
 
-	GraphicObject2D(string name,  Type type, vector<Coordinate*> &coordinateList) :
+	GraphicObject2D(string name,  Type type, const vector<Coordinate> &coordinateList) :
     GraphicObject(name, type) {
-		this->coordinateList = coordinateList;
+		storeCoordinates(coordinateList);
 		computeGeometricCenter();
 	}
 
-	~GraphicObject2D() {
-		vector<Coordinate*>::iterator it;
-		for(it = coordinateList.begin(); it != coordinateList.end(); it++) {
-			delete *it;
-		}
-	}
-
-  vector<Coordinate*> getCoordinates() {
-		return this->coordinateList;
-	}
-
-	void computeGeometricCenter() {
-		cx = 0;
-		cy = 0;
-		cz = 0;
-		vector<Coordinate*>::iterator it;
-		for(it = this->coordinateList.begin(); it != this->coordinateList.end(); it++) {
-			cx += (*it)->getX();
-			cy += (*it)->getY();
-			cz += (*it)->getZ();
-		}
-		cx = cx / this->coordinateList.size();
-		cy = cy / this->coordinateList.size();
-		cz = cz / this->coordinateList.size();
+	GraphicObject2D(string name,  Type type, CoordinateSpan coordinates) :
+    GraphicObject(name, type) {
+		storeCoordinates(coordinates);
+		computeGeometricCenter();
 	}
 };
 
@@ -0,0 +1,108 @@
+#ifndef HEADLESSRENDERER_HPP
+#define HEADLESSRENDERER_HPP
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "displayFile.hpp"
+#include "drawer.hpp"
+#include "objDescriptor.hpp"
+#include "sceneFile.hpp"
+#include "sceneRenderer.hpp"
+#include "scn.hpp"
+#include "softwareRasterizer.hpp"
+#include "viewPipeline.hpp"
+#include "viewport.hpp"
+
+using namespace std;
+
+//! Renders a world file to an image, without GTK (e.g. on a server).
+/*!
+ * The objects are seen with a parallel projection along z and the window is
+ * fitted around all of them. Frames are rendered by a SoftwareRasterizer and
+ * written as PPM or PNG, according to the extension of the file name.
+ */
+class HeadlessRenderer {
+private:
+  DisplayFile display;
+  ViewPipeline pipeline;
+  SoftwareRasterizer* raster;  //!< Owned by 'drawer'.
+  Drawer drawer;
+  SceneRenderer renderer;
+  vector<GraphicObject*> visibleObjects;
+  int width, height;
+
+  //! Fits the window around every object of 'display'.
+  void fitWindow() {
+    BoundingBox box = BoundingBox::empty();
+    for (GraphicObject* obj : display.getObjs())
+      box.merge(obj->getBounds());
+
+    double halfW = 1, halfH = 1;
+    double cx = 0, cy = 0;
+    if (display.size() > 0) {
+      // Half sizes of a window around the box with the aspect of the image
+      double aspect = (double) width / height;
+      halfW = max((box.max[0] - box.min[0]) / 2, (box.max[1] - box.min[1]) / 2 * aspect);
+      halfW = max(halfW * 1.05, 1e-9);
+      halfH = halfW / aspect;
+      cx = box.center(0);
+      cy = box.center(1);
+    }
+
+    // As in the GUI, the projection centers the window and SCN only scales
+    Coordinate origin(0, 0);
+    Coordinate scalingFactor(1/halfW, 1/halfH);
+    ViewPort viewPort({new Coordinate(0, 0), new Coordinate(width, height)}, NULL);
+
+    Scn scn;
+    pipeline.update(Mat4::translation(-cx, -cy, 0), scn.matrix(&origin, &scalingFactor),
+        viewPort.matrix(), 0, 0, 0);
+  }
+
+public:
+  HeadlessRenderer(int width, int height) :
+      raster(new SoftwareRasterizer(max(width, 1), max(height, 1))), drawer(raster),
+      renderer(pipeline, drawer), width(max(width, 1)), height(max(height, 1)) {}
+
+  //! Adds the objects of the world file 'fileName', an OBJ or a scene file (@see SceneFile).
+  void load(string fileName) {
+    vector<GraphicObject*> objs;
+    if (SceneFile::handles(fileName)) {
+      SceneFile sf;
+      objs = sf.read(fileName);
+    } else {
+      ObjDescriptor od;
+      objs = od.read(fileName);
+    }
+    for (size_t i = 0; i < objs.size(); ++i) {
+      display.insert(objs[i]);
+    }
+  }
+
+  //! Renders one frame of the world and writes it to 'fileName'.
+  /*!
+   * @return false if the image could not be written.
+   */
+  bool render(string fileName) {
+    fitWindow();
+
+    drawer.beginFrame();
+    visibleObjects.clear();
+    display.visibleObjects(pipeline.getProjection(), visibleObjects);
+    renderer.render(visibleObjects, 1);  // Cohen-Sutherland, as the GUI starts with
+    drawer.endFrame();
+
+    string extension = fileName.substr(fileName.find_last_of('.') + 1);
+    if (extension == "png" || extension == "PNG")
+      return raster->savePNG(fileName);
+    return raster->savePPM(fileName);
+  }
+
+  SoftwareRasterizer& getRaster() {
+    return *raster;
+  }
+};
+
+#endif  //!< HEADLESSRENDERER_HPP
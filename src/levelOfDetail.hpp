@@ -0,0 +1,147 @@
+#ifndef LEVELOFDETAIL_HPP
+#define LEVELOFDETAIL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <math.h>
+#include <vector>
+
+#include "coordinate.hpp"
+
+using namespace std;
+
+#define CURVE_FLATNESS 0.25        //!< Largest distance between a curve and its polyline, in pixels.
+#define TESSELLATION_MAX_STEPS 1024  //!< Most steps taken over a cubic segment.
+#define TESSELLATION_MAX_SAMPLES (1 << 20)  //!< Most points of the tessellation of one object.
+#define LOD_MIN_LEVEL -32
+#define LOD_MAX_LEVEL 32
+#define LOD_NONE (LOD_MIN_LEVEL - 1)  //!< No level chosen yet.
+#define LOD_CACHE_SIZE 4           //!< Tessellations kept per object.
+
+//! The points of a tessellated curve or surface.
+struct Tessellation {
+  vector<double> xyz;         //!< x, y and z of each point in turn.
+  vector<size_t> gridSizes;   //!< Rows and columns of each sample grid (surfaces only).
+};
+
+//! Levels of detail of curves and surfaces.
+/*!
+ * At level l a world unit spans at most 2^l pixels, so a tessellation
+ * within tolerance(l) world units of the curve stays within CURVE_FLATNESS
+ * pixels of it. Levels are powers of two apart: zooming or moving the
+ * camera only re-tessellates once the scale doubles or halves.
+ */
+class LevelOfDetail {
+public:
+  //! The level of objects on which a world unit spans 'pixelsPerUnit' pixels.
+  static int level(double pixelsPerUnit) {
+    if (!(pixelsPerUnit > 0))
+      return LOD_MIN_LEVEL;
+    return (int) min(max(ceil(log2(pixelsPerUnit)), (double) LOD_MIN_LEVEL), (double) LOD_MAX_LEVEL);
+  }
+
+  //! Flatness tolerance at 'level', in world units.
+  static double tolerance(int level) {
+    return CURVE_FLATNESS / ldexp(1.0, level);
+  }
+
+  //! Steps keeping a cubic within 'tolerance' of its polyline.
+  /*!
+   * Wang's formula: n = sqrt(D / (8 * tolerance)), D bounding the second
+   * derivative of the cubic over [0, 1].
+   */
+  static int steps(double secondDerivative, double tolerance) {
+    if (!(tolerance > 0))
+      return TESSELLATION_MAX_STEPS;
+
+    double n = ceil(sqrt(secondDerivative / (8 * tolerance)));
+    return (int) min(max(n, 1.0), (double) TESSELLATION_MAX_STEPS);
+  }
+
+  //! Lowers 'steps' so that their samples, the sum of (n + 1)^dimensions, stay within TESSELLATION_MAX_SAMPLES.
+  /*!
+   * Zoomed far in, each segment or patch could take TESSELLATION_MAX_STEPS
+   * on its own: the whole object then gets coarser instead, every n + 1
+   * scaled by the same factor. No segment goes below one step, so objects
+   * with more segments or patches than the budget still exceed it.
+   * @param dimensions 1 for the segments of a curve, 2 for the patches of a surface.
+   */
+  static void limitSamples(vector<int> &steps, int dimensions) {
+    double samples = 0;
+    for (int n : steps) {
+      samples += pow(n + 1.0, dimensions);
+    }
+    if (samples <= TESSELLATION_MAX_SAMPLES)
+      return;
+
+    double scale = pow(TESSELLATION_MAX_SAMPLES / samples, 1.0 / dimensions);
+    for (int &n : steps) {
+      n = max(1, (int) floor((n + 1) * scale) - 1);
+    }
+  }
+
+  //! The largest second difference |P(k) - 2 P(k+1) + P(k+2)| of p0..p3.
+  static double secondDifference(const Coordinate& p0, const Coordinate& p1,
+      const Coordinate& p2, const Coordinate& p3) {
+    const Coordinate* p[4] = {&p0, &p1, &p2, &p3};
+    double m2 = 0;
+    for (int k = 0; k < 2; k++) {
+      double dx = p[k]->getX() - 2*p[k+1]->getX() + p[k+2]->getX();
+      double dy = p[k]->getY() - 2*p[k+1]->getY() + p[k+2]->getY();
+      double dz = p[k]->getZ() - 2*p[k+1]->getZ() + p[k+2]->getZ();
+      m2 = max(m2, dx*dx + dy*dy + dz*dz);
+    }
+    return sqrt(m2);
+  }
+};
+
+//! The tessellations of a curve or surface at its last few levels of detail.
+class TessellationCache {
+private:
+  struct Entry {
+    int level;
+    Tessellation tessellation;
+  };
+
+  vector<Entry> entries;  //!< Least recently used first.
+  int current;            //!< Level shown by the object.
+
+public:
+  TessellationCache() : current(LOD_NONE) {}
+
+  int level() const {
+    return current;
+  }
+
+  //! Switches to 'level', calling tessellate(tolerance, tessellation) if it is not cached.
+  /*!
+   * @return The tessellation of 'level', or NULL if it was the current one.
+   */
+  template<typename Tessellate>
+  const Tessellation* select(int level, Tessellate tessellate) {
+    if (level == current)
+      return NULL;
+    current = level;
+
+    for (size_t i = 0; i < entries.size(); i++) {
+      if (entries[i].level == level) {
+        rotate(entries.begin() + i, entries.begin() + i + 1, entries.end());
+        return &entries.back().tessellation;
+      }
+    }
+
+    if (entries.size() == LOD_CACHE_SIZE)
+      entries.erase(entries.begin());
+    entries.push_back({level, Tessellation()});
+    tessellate(LevelOfDetail::tolerance(level), entries.back().tessellation);
+    return &entries.back().tessellation;
+  }
+
+  //! Drops every tessellation, the control points changed.
+  void clear() {
+    entries.clear();
+    current = LOD_NONE;
+  }
+};
+
+#endif  //!< LEVELOFDETAIL_HPP
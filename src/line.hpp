@@ -7,7 +7,10 @@
 
 class Line: public GraphicObject2D {
 public:
-	Line(string name,  vector<Coordinate*> &lineCoordinates) :
+	Line(string name,  const vector<Coordinate> &lineCoordinates) :
+		GraphicObject2D(name, LINE, lineCoordinates) {}
+
+	Line(string name, CoordinateSpan lineCoordinates) :
 		GraphicObject2D(name, LINE, lineCoordinates) {}
 };
 
@@ -0,0 +1,187 @@
+#ifndef LINEBATCHCLIPPING_HPP
+#define LINEBATCHCLIPPING_HPP
+
+#include <algorithm>
+#include <vector>
+
+#if defined(__AVX__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "vertexBuffer.hpp"
+
+using namespace std;
+
+//! Endpoints of many line segments, in structure-of-arrays form.
+/*!
+ * Filled by the caller (@see add()), then clipped all at once by
+ * LineBatchClipping::clip(). t0/t1 receive the Liang-Barsky parameters of
+ * the visible part of each segment (t0 > t1 when nothing is visible).
+ */
+struct SegmentBatch {
+  vector<double> x0, y0, x1, y1;
+  vector<double> t0, t1;
+
+  void clear() {
+    x0.clear(); y0.clear(); x1.clear(); y1.clear();
+  }
+
+  void add(double ax, double ay, double bx, double by) {
+    x0.push_back(ax);
+    y0.push_back(ay);
+    x1.push_back(bx);
+    y1.push_back(by);
+  }
+
+  size_t size() const {
+    return x0.size();
+  }
+};
+
+//! Liang-Barsky clipping of a SegmentBatch against the normalized window.
+/*!
+ * The parameters of every segment are computed with AVX (4 segments per
+ * step) or SSE2 (2 per step) when the compiler targets them, falling back
+ * to plain loops otherwise. The visible parts are then written, compacted,
+ * as pairs of points.
+ */
+class LineBatchClipping {
+private:
+  //! Clips segments [first, end) one by one.
+  static void clipScalar(SegmentBatch& batch, size_t first, size_t end) {
+    for (size_t i = first; i < end; i++) {
+      double dx = batch.x1[i] - batch.x0[i];
+      double dy = batch.y1[i] - batch.y0[i];
+
+      /* `p` or `q` = [left, right, bottom, top] */
+      double p[4] = {-dx, dx, -dy, dy};
+      double q[4] = {batch.x0[i] + 1, 1 - batch.x0[i], batch.y0[i] + 1, 1 - batch.y0[i]};
+
+      double t0 = 0, t1 = 1;
+      for (int k = 0; k < 4; k++) {
+        if (p[k] == 0) {
+          if (q[k] < 0)
+            t0 = 2;  // parallel to and out of the window
+        } else if (p[k] < 0) {
+          t0 = max(t0, q[k] / p[k]);
+        } else {
+          t1 = min(t1, q[k] / p[k]);
+        }
+      }
+
+      batch.t0[i] = t0;
+      batch.t1[i] = t1;
+    }
+  }
+
+#if defined(__AVX__)
+  static size_t clipWide(SegmentBatch& batch) {
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d one = _mm256_set1_pd(1);
+    const __m256d two = _mm256_set1_pd(2);
+
+    size_t n = batch.size() & ~size_t(3);
+    for (size_t i = 0; i < n; i += 4) {
+      __m256d x0 = _mm256_loadu_pd(&batch.x0[i]);
+      __m256d y0 = _mm256_loadu_pd(&batch.y0[i]);
+      __m256d dx = _mm256_sub_pd(_mm256_loadu_pd(&batch.x1[i]), x0);
+      __m256d dy = _mm256_sub_pd(_mm256_loadu_pd(&batch.y1[i]), y0);
+
+      __m256d p[4] = {_mm256_sub_pd(zero, dx), dx, _mm256_sub_pd(zero, dy), dy};
+      __m256d q[4] = {_mm256_add_pd(x0, one), _mm256_sub_pd(one, x0),
+                      _mm256_add_pd(y0, one), _mm256_sub_pd(one, y0)};
+
+      __m256d t0 = zero, t1 = one, rejected = zero;
+      for (int k = 0; k < 4; k++) {
+        __m256d r = _mm256_div_pd(q[k], p[k]);
+        __m256d negative = _mm256_cmp_pd(p[k], zero, _CMP_LT_OQ);
+        __m256d positive = _mm256_cmp_pd(p[k], zero, _CMP_GT_OQ);
+        __m256d parallel = _mm256_cmp_pd(p[k], zero, _CMP_EQ_OQ);
+
+        t0 = _mm256_blendv_pd(t0, _mm256_max_pd(t0, r), negative);
+        t1 = _mm256_blendv_pd(t1, _mm256_min_pd(t1, r), positive);
+        rejected = _mm256_or_pd(rejected,
+            _mm256_and_pd(parallel, _mm256_cmp_pd(q[k], zero, _CMP_LT_OQ)));
+      }
+
+      _mm256_storeu_pd(&batch.t0[i], _mm256_blendv_pd(t0, two, rejected));
+      _mm256_storeu_pd(&batch.t1[i], t1);
+    }
+    return n;
+  }
+#elif defined(__SSE2__)
+  static __m128d select(__m128d a, __m128d b, __m128d mask) {
+    return _mm_or_pd(_mm_andnot_pd(mask, a), _mm_and_pd(mask, b));
+  }
+
+  static size_t clipWide(SegmentBatch& batch) {
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d one = _mm_set1_pd(1);
+    const __m128d two = _mm_set1_pd(2);
+
+    size_t n = batch.size() & ~size_t(1);
+    for (size_t i = 0; i < n; i += 2) {
+      __m128d x0 = _mm_loadu_pd(&batch.x0[i]);
+      __m128d y0 = _mm_loadu_pd(&batch.y0[i]);
+      __m128d dx = _mm_sub_pd(_mm_loadu_pd(&batch.x1[i]), x0);
+      __m128d dy = _mm_sub_pd(_mm_loadu_pd(&batch.y1[i]), y0);
+
+      __m128d p[4] = {_mm_sub_pd(zero, dx), dx, _mm_sub_pd(zero, dy), dy};
+      __m128d q[4] = {_mm_add_pd(x0, one), _mm_sub_pd(one, x0),
+                      _mm_add_pd(y0, one), _mm_sub_pd(one, y0)};
+
+      __m128d t0 = zero, t1 = one, rejected = zero;
+      for (int k = 0; k < 4; k++) {
+        __m128d r = _mm_div_pd(q[k], p[k]);
+        __m128d negative = _mm_cmplt_pd(p[k], zero);
+        __m128d positive = _mm_cmpgt_pd(p[k], zero);
+        __m128d parallel = _mm_cmpeq_pd(p[k], zero);
+
+        t0 = select(t0, _mm_max_pd(t0, r), negative);
+        t1 = select(t1, _mm_min_pd(t1, r), positive);
+        rejected = _mm_or_pd(rejected, _mm_and_pd(parallel, _mm_cmplt_pd(q[k], zero)));
+      }
+
+      _mm_storeu_pd(&batch.t0[i], select(t0, two, rejected));
+      _mm_storeu_pd(&batch.t1[i], t1);
+    }
+    return n;
+  }
+#else
+  static size_t clipWide(SegmentBatch& batch) {
+    return 0;
+  }
+#endif
+
+public:
+  //! Clips every segment of 'batch', appending the visible parts to 'out'.
+  /*!
+   * @param out Receives two points (start, end) per visible segment.
+   * @return The number of visible segments.
+   */
+  static size_t clip(SegmentBatch& batch, vector<Vertex2D>& out) {
+    size_t n = batch.size();
+    batch.t0.resize(n);
+    batch.t1.resize(n);
+
+    size_t done = clipWide(batch);
+    clipScalar(batch, done, n);
+
+    size_t visible = 0;
+    for (size_t i = 0; i < n; i++) {
+      double t0 = batch.t0[i];
+      double t1 = batch.t1[i];
+      if (t0 > t1)
+        continue;
+
+      double dx = batch.x1[i] - batch.x0[i];
+      double dy = batch.y1[i] - batch.y0[i];
+      out.push_back({batch.x0[i] + t0*dx, batch.y0[i] + t0*dy});
+      out.push_back({batch.x0[i] + t1*dx, batch.y0[i] + t1*dy});
+      visible++;
+    }
+    return visible;
+  }
+};
+
+#endif  //!< LINEBATCHCLIPPING_HPP
@@ -1,8 +1,21 @@
+#include <stdlib.h>
+
 #include "controller.hpp"
+#include "headlessRenderer.hpp"
 
 Controller* controller;
 
 int main(int argc, char *argv[]) {
+    // teste.exe --render world.obj|world.scene frame.ppm|frame.png [width height]
+    if (argc >= 4 && string(argv[1]) == "--render") {
+        int width = argc >= 6 ? atoi(argv[4]) : 800;
+        int height = argc >= 6 ? atoi(argv[5]) : 600;
+
+        HeadlessRenderer renderer(width, height);
+        renderer.load(argv[2]);
+        return renderer.render(argv[3]) ? 0 : 1;
+    }
+
     controller = new Controller();
     controller->run(argc, argv);
     
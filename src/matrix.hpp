@@ -26,36 +26,6 @@ public:
   vector<vector<double> >* getMatrixRef() {
     return &matrix;
   }
-  static std::vector<std::vector<double> > coordinateToMatrix(Coordinate* coord) {
-   return {{coord->getX()},
-           {coord->getY()},
-           {1}};
-  }
-
-  static std::vector<std::vector<double> > coordinateOppToMatrix(Coordinate* coord) {
-   return {{coord->getXop()},
-           {coord->getYop()},
-           {1}};
-  }
-
-  static std::vector<std::vector<double> > translationVectorToMatrix(Coordinate* coord) {
-   return {{1, 0, coord->getX()},
-           {0, 1, coord->getY()},
-           {0, 0,      1       }};
-  }
-
-  static std::vector<std::vector<double> > scalingVectorToMatrix(Coordinate* coord) {
-   return {{coord->getX(),      0       , 0},
-           {     0       , coord->getY(), 0},
-           {     0       ,      0       , 1}};
-  }
-
-  static std::vector<std::vector<double> > rotationVectorToMatrix(double angle) {
-   return {{cos(angle), -sin(angle), 0},
-           {sin(angle),  cos(angle), 0},
-           {   0      ,      0     , 1}};
-  }
-
   static const vector<vector<double>> mb() {
     return {{-1.0,  3.0, -3.0, 1.0},
             { 3.0, -6.0,  3.0, 0.0},
@@ -120,107 +90,43 @@ public:
             { 6*delta3,     0.0   ,  0.0 , 0.0}};
   }
 
-  static const vector<vector<double>> gx(vector<Coordinate*> &v) {
-    return {{v[0]->getX()},
-            {v[1]->getX()},
-            {v[2]->getX()},
-            {v[3]->getX()}};
+  static const vector<vector<double>> gx(const vector<Coordinate> &v) {
+    return {{v[0].getX()},
+            {v[1].getX()},
+            {v[2].getX()},
+            {v[3].getX()}};
   }
 
-  static const vector<vector<double>> gy(vector<Coordinate*> &v) {
-    return {{v[0]->getY()},
-            {v[1]->getY()},
-            {v[2]->getY()},
-            {v[3]->getY()}};
+  static const vector<vector<double>> gy(const vector<Coordinate> &v) {
+    return {{v[0].getY()},
+            {v[1].getY()},
+            {v[2].getY()},
+            {v[3].getY()}};
   }
 
-  static const vector<vector<double>> gz(vector<Coordinate*> &v) {
-    return {{v[0]->getZ()},
-            {v[1]->getZ()},
-            {v[2]->getZ()},
-            {v[3]->getZ()}};
+  static const vector<vector<double>> gz(const vector<Coordinate> &v) {
+    return {{v[0].getZ()},
+            {v[1].getZ()},
+            {v[2].getZ()},
+            {v[3].getZ()}};
   }
 
   static const vector<vector<double>> g(const int i, const int j,
-                  const vector<vector<Coordinate*>> &v, const int axis) {
+                  const vector<vector<Coordinate>> &v, const int axis) {
     vector<vector<double>> m = {
             {0,0,0,0},
             {0,0,0,0},
             {0,0,0,0},
             {0,0,0,0}
     };
-    for (int k = i; k <= i + 3; ++k) {
-      for (int l = i; l <= i + 3; ++l) {
-        m[k][l] = v[k][l]->get(axis);
+    for (int k = 0; k < 4; ++k) {
+      for (int l = 0; l < 4; ++l) {
+        m[k][l] = v[i + k][j + l].get(axis);
       }
     }
     return m;
   }
 
-  static std::vector<std::vector<double> > translation3DVectorToMatrix(Coordinate* coord) {
-   return {{1, 0,  0, coord->getX()},
-           {0, 1,  0, coord->getY()},
-           {0, 0,  1, coord->getZ()},
-           {0, 0,  0,      1       }};
-  }
-
-  static std::vector<std::vector<double> > rotationXVectorToMatrix(double angle) {
-   return {{1,    0      ,     0      , 0},
-           {0, cos(angle), -sin(angle), 0},
-           {0, sin(angle),  cos(angle), 0},
-           {0,    0      ,     0      , 1}};
-  }
-
-  static std::vector<std::vector<double> > rotationYVectorToMatrix(double angle) {
-   return {{ cos(angle), 0, sin(angle), 0},
-           {    0      , 1,      0    , 0},
-           {-sin(angle), 0, cos(angle), 0},
-           {    0      , 0,      0    , 1}};
-  }
-
-  static std::vector<std::vector<double> > rotationZVectorToMatrix(double angle) {
-   return {{cos(angle), -sin(angle), 0 , 0},
-           {sin(angle),  cos(angle), 0 , 0},
-           {    0     ,     0      , 1 , 0},
-           {    0     ,     0      , 0 , 1}};
-  }
-
-  static std::vector<std::vector<double> > coordinate3DToMatrix(Coordinate* coord) {
-   return {{coord->getX()},
-           {coord->getY()},
-           {coord->getZ()},
-           {1}};
-  }
-
-  static std::vector<std::vector<double> > coordinate3DToMatrixOp(Coordinate* coord) {
-   return {{coord->getXop()},
-           {coord->getYop()},
-           {coord->getZop()},
-           {1}};
-  }
-
-  static std::vector<std::vector<double> > scaling3DVectorToMatrix(Coordinate* coord) {
-   return {{coord->getX(),       0      ,      0       , 0},
-           {    0        , coord->getY(),      0       , 0},
-           {    0        ,       0      , coord->getZ(), 0},
-           {    0        ,       0      ,      0       , 1}};
-        printf("transpose \n");
-  }
-
-  static std::vector<std::vector<double> > genericRotationAlpha(double cy, double cz, double d) {
-   return {{1,   0  ,   0  , 0},
-           {0,  cz/d, -cy/d, 0},
-           {0,  cy/d,  cz/d, 0},
-           {0,   0  ,   0  , 1}};
-  }
-
-  static std::vector<std::vector<double> > genericRotationBeta(double cx, double d) {
-   return {{  d, -cx, 0, 0},
-           { cx,  d , 0, 0},
-           {  0,  0 , 1, 0},
-           {  0,  0 , 0, 1}};
-  }
-
   static void transpose(Matrix& matr) {
     Matrix result({
         {0,0,0,0},
@@ -240,9 +146,9 @@ public:
     }
   }
 
-  Matrix operator* (Matrix& obj) {
+  Matrix operator* (const Matrix& obj) const {
     std::vector<std::vector<double> > newMatrix;
-    std::vector<std::vector<double> > objVector = obj.getMatrix();
+    const std::vector<std::vector<double> > &objVector = obj.matrix;
 
     newMatrix.resize(matrix.size());
     for(int i = 0; i < matrix.size(); i++) {
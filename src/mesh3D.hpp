@@ -0,0 +1,69 @@
+#ifndef MESH3D_HPP
+#define MESH3D_HPP
+
+#include <cstdint>
+#include <vector>
+
+#include "graphicObject.hpp"
+
+using namespace std;
+
+/*! A polygon mesh: shared vertices plus edge and face index buffers */
+
+class Mesh3D: public GraphicObject {
+private:
+  vector<uint32_t> edges;      //!< Two vertex indexes per edge, each edge once.
+  vector<uint32_t> faces;      //!< Vertex indexes of the corners of every face, back to back.
+  vector<uint32_t> faceSizes;  //!< Number of corners of each face.
+  FrameSpan<Vertex2D> windowSegments;  //!< Visible parts of the edges, two points each, for the current frame.
+
+public:
+  //! A mesh with vertices 'xyz' (x, y and z of each one in turn).
+  /*!
+   * Indexes are relative to the first vertex of the mesh. The index
+   * buffers are taken over by the mesh.
+   */
+  Mesh3D(string name, const vector<double> &xyz, vector<uint32_t> &&edges,
+      vector<uint32_t> &&faces, vector<uint32_t> &&faceSizes) :
+      GraphicObject(name, MESH3D), edges(move(edges)), faces(move(faces)),
+      faceSizes(move(faceSizes)), windowSegments{NULL, 0} {
+    storeCoordinates(xyz);
+    computeGeometricCenter();
+  }
+
+  //! A mesh with vertices 'coordinates' (@see Mesh3D(string, const vector<double>&, ...)).
+  Mesh3D(string name, CoordinateSpan coordinates, vector<uint32_t> &&edges,
+      vector<uint32_t> &&faces, vector<uint32_t> &&faceSizes) :
+      GraphicObject(name, MESH3D), edges(move(edges)), faces(move(faces)),
+      faceSizes(move(faceSizes)), windowSegments{NULL, 0} {
+    storeCoordinates(coordinates);
+    computeGeometricCenter();
+  }
+
+  size_t edgeCount() const {
+    return edges.size() / 2;
+  }
+
+  const vector<uint32_t>& getEdges() const {
+    return edges;
+  }
+
+  const vector<uint32_t>& getFaces() const {
+    return faces;
+  }
+
+  const vector<uint32_t>& getFaceSizes() const {
+    return faceSizes;
+  }
+
+  FrameSpan<Vertex2D> getWindowSegments() {
+    return windowSegments;
+  }
+
+  void setWindowSegments(FrameSpan<Vertex2D> segments) {
+    windowSegments = segments;
+  }
+
+};
+
+#endif  //!< MESH3D_HPP
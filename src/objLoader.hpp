@@ -0,0 +1,276 @@
+#ifndef OBJLOADER_HPP
+#define OBJLOADER_HPP
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "workerPool.hpp"
+
+using namespace std;
+
+#define OBJ_MIN_CHUNK_SIZE (1 << 20)
+#define OBJ_RELATIVE_INDEX ((int64_t) 1 << 62)  //!< Offset of the relative indexes (@see ObjLoader::encode()).
+
+//! The geometry of a Wavefront OBJ file as an indexed mesh (@see Mesh3D).
+struct ObjMesh {
+  vector<double> xyz;          //!< Vertices, x, y and z of each one in turn.
+  vector<uint32_t> edges;      //!< Unique edges (a < b) of the faces and lines, sorted.
+  vector<uint32_t> faces;      //!< Corners of the faces, back to back.
+  vector<uint32_t> faceSizes;  //!< Number of corners of each face.
+
+  size_t vertexCount() const {
+    return xyz.size() / 3;
+  }
+};
+
+//! Parses OBJ files in parallel, straight from a memory mapping.
+/*!
+ * The file is cut in chunks at line boundaries and each chunk is parsed on
+ * the WorkerPool into its own vertex and polygon lists. Vertices are kept
+ * once, indexed as in the file. Faces ('f') are kept as they are; their
+ * sides and polylines ('l') give the edges, and an edge shared by several
+ * faces is kept once.
+ *
+ * Only geometry is read: texture coordinates, normals, groups and
+ * materials are skipped.
+ */
+class ObjLoader {
+private:
+  //! What a chunk of the file holds.
+  struct Chunk {
+    const char *begin, *end;
+    vector<double> xyz;
+    vector<int64_t> indexes;    //!< Vertex of each polygon corner (@see resolve()).
+    vector<uint32_t> sizes;     //!< Number of corners of each polygon.
+    vector<uint8_t> closed;     //!< 1 for faces, 0 for polylines.
+    size_t firstVertex;         //!< Vertices in the chunks before this one.
+    vector<uint64_t> edgeKeys;  //!< Edges of the chunk (@see edgeKey()).
+    vector<uint32_t> faces;     //!< Faces of the chunk, with resolved indexes.
+    vector<uint32_t> faceSizes;
+  };
+
+  static const char* skipBlanks(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+      p++;
+    return p;
+  }
+
+  static const char* nextLine(const char* p, const char* end) {
+    const char* eol = (const char*) memchr(p, '\n', end - p);
+    return eol ? eol + 1 : end;
+  }
+
+  static uint64_t edgeKey(uint64_t a, uint64_t b) {
+    return a < b ? (a << 32 | b) : (b << 32 | a);
+  }
+
+  //! Index of a polygon corner as stored in a Chunk.
+  /*!
+   * OBJ indexes start at 1; negative ones count back from the last vertex
+   * read so far. Positive ones are kept as 0 based indexes. Negative ones
+   * are kept relative to the first vertex of the chunk, because the
+   * vertices of the previous chunks are not known yet, minus
+   * OBJ_RELATIVE_INDEX: they stay negative even when they point into an
+   * earlier chunk, so they never pass for absolute ones.
+   */
+  static int64_t encode(int64_t index, size_t chunkVertices) {
+    if (index > 0)
+      return index - 1;
+    index = max(index, -(OBJ_RELATIVE_INDEX >> 1));
+    return (int64_t) chunkVertices + index - OBJ_RELATIVE_INDEX;
+  }
+
+  //! The index of the whole file of 'encoded', read in a chunk starting at 'firstVertex'.
+  static int64_t resolve(int64_t encoded, size_t firstVertex) {
+    return encoded >= 0 ? encoded : (int64_t) firstVertex + (encoded + OBJ_RELATIVE_INDEX);
+  }
+
+  static void parseChunk(Chunk& chunk) {
+    const char* p = chunk.begin;
+    const char* end = chunk.end;
+
+    while (p < end) {
+      const char* line = skipBlanks(p, end);
+      const char* eol = (const char*) memchr(line, '\n', end - line);
+      if (!eol)
+        eol = end;
+      p = eol < end ? eol + 1 : end;
+
+      if (eol - line < 2 || (line[1] != ' ' && line[1] != '\t'))
+        continue;
+
+      if (line[0] == 'v') {
+        const char* q = line + 1;
+        double v[3];
+        int read = 0;
+        for (; read < 3; read++) {
+          q = skipBlanks(q, eol);
+          from_chars_result r = from_chars(q, eol, v[read]);
+          if (r.ec != errc())
+            break;
+          q = r.ptr;
+        }
+        if (read == 3)
+          chunk.xyz.insert(chunk.xyz.end(), v, v + 3);
+      } else if (line[0] == 'f' || line[0] == 'l') {
+        const char* q = line + 1;
+        size_t vertices = chunk.xyz.size() / 3;
+        uint32_t corners = 0;
+        while (true) {
+          q = skipBlanks(q, eol);
+          int64_t index;
+          from_chars_result r = from_chars(q, eol, index);
+          if (r.ec != errc() || index == 0)
+            break;
+          chunk.indexes.push_back(encode(index, vertices));
+          corners++;
+
+          // Skip the texture and normal indexes ("v/t/n", "v//n")
+          q = r.ptr;
+          while (q < eol && *q != ' ' && *q != '\t' && *q != '\r')
+            q++;
+        }
+
+        if (corners > 0) {
+          chunk.sizes.push_back(corners);
+          chunk.closed.push_back(line[0] == 'f');
+        }
+      }
+    }
+  }
+
+  //! Resolves the polygons of 'chunk' into its faces and edges.
+  /*!
+   * Polygons with an index out of [0, vertexCount) are dropped.
+   */
+  static void collectEdges(Chunk& chunk, size_t vertexCount) {
+    size_t first = 0;
+    for (size_t polygon = 0; polygon < chunk.sizes.size(); polygon++) {
+      size_t n = chunk.sizes[polygon];
+      bool valid = true;
+      for (size_t i = first; i < first + n; i++) {
+        chunk.indexes[i] = resolve(chunk.indexes[i], chunk.firstVertex);
+        valid = valid && chunk.indexes[i] >= 0 && (size_t) chunk.indexes[i] < vertexCount;
+      }
+
+      if (valid) {
+        bool face = chunk.closed[polygon] && n > 2;
+        if (face) {
+          chunk.faces.insert(chunk.faces.end(), chunk.indexes.begin() + first, chunk.indexes.begin() + first + n);
+          chunk.faceSizes.push_back(n);
+        }
+
+        size_t sides = face ? n : n - 1;
+        for (size_t i = 0; i < sides; i++) {
+          int64_t a = chunk.indexes[first + i];
+          int64_t b = chunk.indexes[first + (i + 1) % n];
+          if (a != b)
+            chunk.edgeKeys.push_back(edgeKey(a, b));
+        }
+      }
+      first += n;
+    }
+  }
+
+  static bool parse(const char* data, size_t size, ObjMesh& mesh, WorkerPool& pool) {
+    // Chunks end right after a newline (or at the end of the file)
+    size_t count = max((size_t) 1, min((size_t) pool.size() * 4, size / OBJ_MIN_CHUNK_SIZE));
+    vector<Chunk> chunks(count);
+    const char* end = data + size;
+    const char* p = data;
+    for (size_t i = 0; i < count; i++) {
+      chunks[i].begin = p;
+      p = (i + 1 == count) ? end : nextLine(max(p, data + size * (i + 1) / count), end);
+      chunks[i].end = p;
+    }
+
+    pool.parallelFor(count, 1, [&](size_t begin, size_t last, unsigned) {
+      for (size_t i = begin; i < last; i++)
+        parseChunk(chunks[i]);
+    });
+
+    size_t vertexCount = 0;
+    for (Chunk& chunk : chunks) {
+      chunk.firstVertex = vertexCount;
+      vertexCount += chunk.xyz.size() / 3;
+    }
+
+    pool.parallelFor(count, 1, [&](size_t begin, size_t last, unsigned) {
+      for (size_t i = begin; i < last; i++)
+        collectEdges(chunks[i], vertexCount);
+    });
+
+    mesh.xyz.resize(vertexCount * 3);
+    size_t edgeCount = 0;
+    for (Chunk& chunk : chunks) {
+      copy(chunk.xyz.begin(), chunk.xyz.end(), mesh.xyz.begin() + chunk.firstVertex * 3);
+      mesh.faces.insert(mesh.faces.end(), chunk.faces.begin(), chunk.faces.end());
+      mesh.faceSizes.insert(mesh.faceSizes.end(), chunk.faceSizes.begin(), chunk.faceSizes.end());
+      edgeCount += chunk.edgeKeys.size();
+    }
+
+    // An edge shared by two faces appears twice: sort and keep one
+    vector<uint64_t> keys;
+    keys.reserve(edgeCount);
+    for (Chunk& chunk : chunks) {
+      keys.insert(keys.end(), chunk.edgeKeys.begin(), chunk.edgeKeys.end());
+      vector<uint64_t>().swap(chunk.edgeKeys);
+    }
+    sort(keys.begin(), keys.end());
+    keys.erase(unique(keys.begin(), keys.end()), keys.end());
+
+    mesh.edges.resize(2*keys.size());
+    for (size_t i = 0; i < keys.size(); i++) {
+      mesh.edges[2*i] = keys[i] >> 32;
+      mesh.edges[2*i + 1] = keys[i] & 0xffffffff;
+    }
+
+    return true;
+  }
+
+public:
+  //! Reads the OBJ file 'fileName' into 'mesh'.
+  /*!
+   * @return false if the file could not be opened or mapped.
+   */
+  static bool load(string fileName, ObjMesh& mesh, WorkerPool& pool = WorkerPool::shared()) {
+    mesh.xyz.clear();
+    mesh.edges.clear();
+    mesh.faces.clear();
+    mesh.faceSizes.clear();
+
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+      return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+      close(fd);
+      return false;
+    }
+    if (info.st_size == 0) {
+      close(fd);
+      return true;
+    }
+
+    void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+      return false;
+    madvise(data, info.st_size, MADV_SEQUENTIAL);
+
+    bool loaded = parse((const char*) data, info.st_size, mesh, pool);
+    munmap(data, info.st_size);
+    return loaded;
+  }
+};
+
+#endif  //!< OBJLOADER_HPP
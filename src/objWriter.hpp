@@ -0,0 +1,286 @@
+#ifndef OBJWRITER_HPP
+#define OBJWRITER_HPP
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "curve.hpp"
+#include "mesh3D.hpp"
+#include "object3D.hpp"
+#include "polygon.hpp"
+#include "surface.hpp"
+
+using namespace std;
+
+#define OBJ_WRITE_BUFFER_SIZE (1 << 20)
+
+//! Writes graphic objects to a Wavefront OBJ file.
+/*!
+ * Each object is written as an 'o' line with its name, the vertices not
+ * written yet and its elements: points ('p'), polylines ('l') for lines,
+ * curves, segments, rows and columns of surface grids and mesh edges
+ * outside faces, and faces ('f') for polygons and mesh faces. Vertex
+ * indexes are global to the file and vertices with the very same
+ * coordinates are written once.
+ *
+ * Text is formatted with to_chars() into a large buffer that is written
+ * out whenever it fills up.
+ */
+class ObjWriter {
+private:
+  int fd;
+  bool failed;
+  vector<char> buffer;
+  size_t used;
+
+  //! Index + 1 of a written vertex in each slot, 0 if the slot is empty.
+  vector<uint32_t> slots;
+  vector<double> written;   //!< Coordinates of the written vertices.
+  vector<uint32_t> indexes; //!< File index of each vertex of the current object.
+  vector<uint32_t> column;  //!< Vertexes of a column of a surface grid.
+
+  void flush() {
+    size_t done = 0;
+    while (!failed && done < used) {
+      ssize_t count = ::write(fd, buffer.data() + done, used - done);
+      if (count < 0 && errno != EINTR)
+        failed = true;
+      else if (count > 0)
+        done += count;
+    }
+    used = 0;
+  }
+
+  //! Makes room for 'count' more characters.
+  char* reserve(size_t count) {
+    if (used + count > buffer.size())
+      flush();
+    return buffer.data() + used;
+  }
+
+  void put(const char* text, size_t length) {
+    memcpy(reserve(length), text, length);
+    used += length;
+  }
+
+  void put(const char* text) {
+    put(text, strlen(text));
+  }
+
+  void put(double value) {
+    char* p = reserve(32);
+    used = to_chars(p, p + 32, value).ptr - buffer.data();
+  }
+
+  void put(uint32_t value) {
+    char* p = reserve(16);
+    used = to_chars(p, p + 16, value).ptr - buffer.data();
+  }
+
+  //! A line with the file index of each vertex in 'local' (relative to the object).
+  void putElement(const char* kind, const uint32_t* local, size_t count) {
+    put(kind);
+    for (size_t i = 0; i < count; i++) {
+      put(" ", 1);
+      put(indexes[local[i]]);
+    }
+    put("\n", 1);
+  }
+
+  //! A line with the file index of 'count' vertices of the object, from 'first' on.
+  void putRun(const char* kind, size_t first, size_t count) {
+    put(kind);
+    for (size_t i = first; i < first + count; i++) {
+      put(" ", 1);
+      put(indexes[i]);
+    }
+    put("\n", 1);
+  }
+
+  static uint64_t bits(double value) {
+    uint64_t result;
+    memcpy(&result, &value, sizeof(result));
+    return result;
+  }
+
+  static size_t hash(double x, double y, double z) {
+    uint64_t h = bits(x) * 0x9e3779b97f4a7c15ull;
+    h = (h ^ (h >> 29) ^ bits(y)) * 0xbf58476d1ce4e5b9ull;
+    h = (h ^ (h >> 31) ^ bits(z)) * 0x94d049bb133111ebull;
+    return h ^ (h >> 32);
+  }
+
+  bool sameVertex(uint32_t index, double x, double y, double z) {
+    const double* v = &written[3 * index];
+    return bits(v[0]) == bits(x) && bits(v[1]) == bits(y) && bits(v[2]) == bits(z);
+  }
+
+  //! The 1 based file index of vertex (x, y, z), writing it if it is new.
+  uint32_t vertex(double x, double y, double z) {
+    size_t mask = slots.size() - 1;
+    size_t slot = hash(x, y, z) & mask;
+    while (slots[slot] != 0) {
+      if (sameVertex(slots[slot] - 1, x, y, z))
+        return slots[slot];
+      slot = (slot + 1) & mask;
+    }
+
+    written.push_back(x);
+    written.push_back(y);
+    written.push_back(z);
+    slots[slot] = written.size() / 3;
+
+    put("v ", 2);
+    put(x);
+    put(" ", 1);
+    put(y);
+    put(" ", 1);
+    put(z);
+    put("\n", 1);
+    return slots[slot];
+  }
+
+  //! Writes the vertices of 'object' not written yet and maps them to file indexes.
+  void putVertices(GraphicObject* object) {
+    VertexBuffer& vertexBuffer = VertexBuffer::scene();
+    VertexRange range = object->getVertices();
+    indexes.resize(range.count);
+    for (size_t i = 0; i < range.count; i++) {
+      size_t v = range.first + i;
+      indexes[i] = vertex(vertexBuffer.getX(v), vertexBuffer.getY(v), vertexBuffer.getZ(v));
+    }
+  }
+
+  //! Faces, then the edges that are not a side of any face, as polylines.
+  void putMesh(Mesh3D* mesh) {
+    const vector<uint32_t>& faces = mesh->getFaces();
+    const vector<uint32_t>& edges = mesh->getEdges();
+    vector<uint64_t> sides;
+    sides.reserve(faces.size());
+
+    size_t corner = 0;
+    for (uint32_t size : mesh->getFaceSizes()) {
+      putElement("f", &faces[corner], size);
+      for (uint32_t i = 0; i < size; i++) {
+        uint64_t a = faces[corner + i], b = faces[corner + (i + 1) % size];
+        sides.push_back(a < b ? (a << 32 | b) : (b << 32 | a));
+      }
+      corner += size;
+    }
+    sort(sides.begin(), sides.end());
+
+    for (size_t i = 0; i + 1 < edges.size(); i += 2) {
+      uint64_t a = edges[i], b = edges[i + 1];
+      if (!binary_search(sides.begin(), sides.end(), a < b ? (a << 32 | b) : (b << 32 | a)))
+        putElement("l", &edges[i], 2);
+    }
+  }
+
+  //! The rows and the columns of each sample grid of 'surface', as polylines.
+  void putSurface(Surface* surface) {
+    size_t base = surface->getVertices().first;
+    for (const SampleGrid& grid : surface->getGrids()) {
+      if (grid.rows < 2 || grid.columns < 2)
+        continue;
+
+      for (size_t r = 0; r < grid.rows; r++) {
+        putRun("l", grid.at(r, 0) - base, grid.columns);
+      }
+      column.resize(grid.rows);
+      for (size_t c = 0; c < grid.columns; c++) {
+        for (size_t r = 0; r < grid.rows; r++) {
+          column[r] = grid.at(r, c) - base;
+        }
+        putElement("l", column.data(), grid.rows);
+      }
+    }
+  }
+
+  void putObject(GraphicObject* object) {
+    put("o ", 2);
+    string name = object->getObjectName();
+    put(name.data(), name.size());
+    put("\n", 1);
+
+    putVertices(object);
+    VertexRange range = object->getVertices();
+    switch (object->getType()) {
+      case POINT:
+        putRun("p", 0, range.count);
+        break;
+      case LINE:
+      case CURVE:
+        if (range.count > 1)
+          putRun("l", 0, range.count);
+        break;
+      case POLYGON:
+        if (range.count > 2)
+          putRun("f", 0, range.count);
+        else if (range.count == 2)
+          putRun("l", 0, range.count);
+        break;
+      case OBJECT3D:
+        for (const Segment& segment : static_cast<Object3D*>(object)->getSegmentList()) {
+          uint32_t ends[2] = {(uint32_t) segment.getA(), (uint32_t) segment.getB()};
+          putElement("l", ends, 2);
+        }
+        break;
+      case MESH3D:
+        putMesh(static_cast<Mesh3D*>(object));
+        break;
+      case SURFACE:
+        putSurface(static_cast<Surface*>(object));
+        break;
+      default:
+        break;
+    }
+  }
+
+public:
+  ObjWriter() : fd(-1), failed(false), buffer(OBJ_WRITE_BUFFER_SIZE), used(0) {}
+
+  //! Writes 'objs' to 'fileName'.
+  /*!
+   * @return false if the file could not be written.
+   */
+  bool write(const vector<GraphicObject*> &objs, string fileName) {
+    fd = open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+      return false;
+
+    size_t vertexCount = 0;
+    for (GraphicObject* object : objs) {
+      vertexCount += object->getVertices().count;
+    }
+
+    // At most half full, so probes stay short
+    size_t capacity = 16;
+    while (capacity < 2 * vertexCount)
+      capacity *= 2;
+    slots.assign(capacity, 0);
+    written.clear();
+    written.reserve(3 * vertexCount);
+    failed = false;
+    used = 0;
+
+    for (GraphicObject* object : objs) {
+      putObject(object);
+    }
+    flush();
+
+    bool closed = close(fd) == 0;
+    fd = -1;
+    vector<uint32_t>().swap(slots);
+    vector<double>().swap(written);
+    return closed && !failed;
+  }
+};
+
+#endif  //!< OBJWRITER_HPP
@@ -4,79 +4,50 @@
 #include "graphicObject.hpp"
 #include "segment.hpp"
 
-/*! Structures a representation and behavior of a "line segment" */
+/*! Structures a representation and behavior of a 3D wireframe object */
 
 // TODO Review public/private scopes
 
 class Object3D: public GraphicObject {
 private:
-  vector<Segment*> segmentList;
-  vector<Coordinate*> allCoord;
-
-  void storeAllCoord() {
-    vector<Segment*>::iterator segment;
-    for(segment = segmentList.begin(); segment != segmentList.end(); segment++) {
-        vector<Coordinate*> segmentCoord = (*segment)->getCoordinates();
-        allCoord.insert(allCoord.end(), segmentCoord.begin(), segmentCoord.end());
-    }
-  }
+  vector<Segment> segmentList;
+  FrameSpan<Vertex2D> windowSegments;  //!< Visible parts of the segments, two points each, for the current frame.
 
 public:
-  Object3D(string name) : GraphicObject(name, OBJECT3D) {}
+  Object3D(string name) : GraphicObject(name, OBJECT3D), windowSegments{NULL, 0} {}
 
-	Object3D(string name, vector<Segment*> &segmentList) :
-		GraphicObject(name, OBJECT3D) {
+  //! A wireframe whose edges are pairs of indexes into 'vertices'.
+	Object3D(string name, const vector<Coordinate> &vertices, const vector<Segment> &segmentList) :
+		GraphicObject(name, OBJECT3D), windowSegments{NULL, 0} {
       this->segmentList = segmentList;
+      storeCoordinates(vertices);
       computeGeometricCenter();
-      storeAllCoord();
     }
 
-  ~Object3D() {
-    vector<Segment*>::iterator it;
-    for(it = segmentList.begin(); it != segmentList.end(); it++) {
-      delete *it;
-    }
+  //! A wireframe with vertices 'xyz' (x, y and z of each one in turn), taking over 'segmentList'.
+  Object3D(string name, const vector<double> &xyz, vector<Segment> &&segmentList) :
+      GraphicObject(name, OBJECT3D), segmentList(move(segmentList)), windowSegments{NULL, 0} {
+    storeCoordinates(xyz);
+    computeGeometricCenter();
   }
 
-  vector<Segment*> getSegmentList() {
-    return this->segmentList;
+  //! A wireframe with vertices 'coordinates', taking over 'segmentList'.
+  Object3D(string name, CoordinateSpan coordinates, vector<Segment> &&segmentList) :
+      GraphicObject(name, OBJECT3D), segmentList(move(segmentList)), windowSegments{NULL, 0} {
+    storeCoordinates(coordinates);
+    computeGeometricCenter();
   }
 
-  vector<Coordinate*> getAllCoord() {
-    return this->allCoord;
+  vector<Segment>& getSegmentList() {
+    return this->segmentList;
   }
 
-  void computeGeometricCenter() {
-    this->cx = 0;
-    this->cy = 0;
-    this->cz = 0;
-    int qtdCoord = 0;
-
-    vector<Segment*>::iterator segment;
-    vector<Coordinate*>::iterator coord;
-    for(segment = segmentList.begin(); segment != segmentList.end(); segment++) {
-      vector<Coordinate*> tmp = (*segment)->getCoordinates();
-      for(coord = tmp.begin(); coord != tmp.end(); coord++) {
-        cx += (*coord)->getX();
-        cy += (*coord)->getY();
-        cz += (*coord)->getZ();
-        qtdCoord++;
-      }
-    }
-
-    this->cx = this->cx / qtdCoord;
-    this->cy = this->cy / qtdCoord;
-    this->cz = this->cz / qtdCoord;
+  FrameSpan<Vertex2D> getWindowSegments() {
+    return this->windowSegments;
   }
 
-  void addCoordinate(Coordinate* c) {
-    int size = allCoord.size();
-    if (size % 2 == 1) {
-      // the last Coordinate in allCoord now can form a Segment
-      segmentList.push_back(new Segment(allCoord[size-1], c));
-    }
-
-    allCoord.push_back(c);
+  void setWindowSegments(FrameSpan<Vertex2D> segments) {
+    this->windowSegments = segments;
   }
 
 };
@@ -1,8 +1,10 @@
 #ifndef OBJECTTRANSFORMATION_HPP
 #define OBJECTTRANSFORMATION_HPP
 
-#include "matrix.hpp"
+#include "fixedMatrix.hpp"
+#include "graphicObject.hpp"
 #include "orthogonalParallelProjection.hpp"
+#include "vertexBuffer.hpp"
 
 /*! Applies translation, scaling or rotation transformations to an object. */
 
@@ -10,108 +12,60 @@ class ObjectTransformation {
 
 public:
 
-  static void translation(vector<Coordinate*> coordinates, Coordinate* translationVector) {
-    Matrix translationMatrix(Matrix::translation3DVectorToMatrix(translationVector));
+  static void translation(GraphicObject* object, Coordinate* translationVector) {
+    Mat4 translationMatrix = Mat4::translation(translationVector->getX(),
+        translationVector->getY(), translationVector->getZ());
 
-    vector<Coordinate*>::iterator it;
-    for(it = coordinates.begin(); it != coordinates.end(); it++) {
-      Matrix coord(Matrix::coordinate3DToMatrix(*it));
-
-      Matrix translatedObject = translationMatrix * coord;
-
-      (*it)->setX(translatedObject.getMatrix()[0][0]);
-      (*it)->setY(translatedObject.getMatrix()[1][0]);
-      (*it)->setZ(translatedObject.getMatrix()[2][0]);
-    }
+    object->transform(translationMatrix);
   }
 
-  static void scaling(vector<Coordinate*> coordinates, Coordinate* objCenter, Coordinate* scalingVector) {
-    Coordinate negativeObjCenter(-objCenter->getX(), -objCenter->getY(), -objCenter->getZ());
-
-    Matrix scalingMatrix(Matrix::scaling3DVectorToMatrix(scalingVector));
-    Matrix translationMatrix1(Matrix::translation3DVectorToMatrix(objCenter));
-    Matrix translationMatrix2(Matrix::translation3DVectorToMatrix(&negativeObjCenter));
-
-    Matrix scalingOperation = translationMatrix1 * scalingMatrix * translationMatrix2;
+  static void scaling(GraphicObject* object, Coordinate* objCenter, Coordinate* scalingVector) {
+    Mat4 scalingMatrix = Mat4::scaling(scalingVector->getX(), scalingVector->getY(), scalingVector->getZ());
+    Mat4 translationMatrix1 = Mat4::translation(objCenter->getX(), objCenter->getY(), objCenter->getZ());
+    Mat4 translationMatrix2 = Mat4::translation(-objCenter->getX(), -objCenter->getY(), -objCenter->getZ());
 
-    vector<Coordinate*>::iterator it;
-    for(it = coordinates.begin(); it != coordinates.end(); it++) {
-      Matrix coord(Matrix::coordinate3DToMatrix(*it));
-
-      Matrix scaledObject = scalingOperation * coord;
-
-      (*it)->setX(scaledObject.getMatrix()[0][0]);
-      (*it)->setY(scaledObject.getMatrix()[1][0]);
-      (*it)->setZ(scaledObject.getMatrix()[2][0]);
-    }
+    object->transform(translationMatrix1 * scalingMatrix * translationMatrix2);
   }
 
-  static void rotation(vector<Coordinate*> coordinates, double angle, Coordinate* rotationVector, int whichAxis) {
+  static void rotation(GraphicObject* object, double angle, Coordinate* rotationVector, int whichAxis) {
     double radians = (angle*M_PI)/180;
 
-    Coordinate negRotationVector(-rotationVector->getX(), -rotationVector->getY(), -rotationVector->getZ());
-
-    Matrix translation(Matrix::translation3DVectorToMatrix(rotationVector));
-    Matrix rotationX(ObjectTransformation::getRotationMatrix(ObjectTransformation::getAngleX(rotationVector), 1));
-    Matrix rotationZ(ObjectTransformation::getRotationMatrix(ObjectTransformation::getAnguloZ(rotationVector), 3));
-    Matrix rotationMatrix(ObjectTransformation::getRotationMatrix(radians, whichAxis));
-    Matrix rotationZinv(ObjectTransformation::getRotationMatrix(-ObjectTransformation::getAnguloZ(rotationVector), 3));
-    Matrix rotationXinv(ObjectTransformation::getRotationMatrix(-ObjectTransformation::getAngleX(rotationVector), 1));
-    Matrix translationInv(Matrix::translation3DVectorToMatrix(&negRotationVector));
+    Mat4 translation = Mat4::translation(rotationVector->getX(), rotationVector->getY(), rotationVector->getZ());
+    Mat4 rotationX = ObjectTransformation::getRotationMatrix(ObjectTransformation::getAngleX(rotationVector), 1);
+    Mat4 rotationZ = ObjectTransformation::getRotationMatrix(ObjectTransformation::getAnguloZ(rotationVector), 3);
+    Mat4 rotationMatrix = ObjectTransformation::getRotationMatrix(radians, whichAxis);
+    Mat4 rotationZinv = ObjectTransformation::getRotationMatrix(-ObjectTransformation::getAnguloZ(rotationVector), 3);
+    Mat4 rotationXinv = ObjectTransformation::getRotationMatrix(-ObjectTransformation::getAngleX(rotationVector), 1);
+    Mat4 translationInv = Mat4::translation(-rotationVector->getX(), -rotationVector->getY(), -rotationVector->getZ());
 
-    Matrix result = translation * rotationX * rotationZ * rotationMatrix * rotationZinv * rotationXinv * translationInv;
+    Mat4 result = translation * rotationX * rotationZ * rotationMatrix * rotationZinv * rotationXinv * translationInv;
 
-    vector<Coordinate*>::iterator it;
-    for(it = coordinates.begin(); it != coordinates.end(); it++) {
-      Matrix coord(Matrix::coordinate3DToMatrix(*it));
-
-      Matrix rotatedObject = result * coord;
-
-      (*it)->setX(rotatedObject.getMatrix()[0][0]);
-      (*it)->setY(rotatedObject.getMatrix()[1][0]);
-      (*it)->setZ(rotatedObject.getMatrix()[2][0]);
-    }
+    object->transform(result);
   }
 
-  static void cameraRotation(vector<Coordinate*> coordinates, Coordinate* geoCenter, double angleX, double angleY, double angleZ) {
-    Coordinate negRotationVector(-geoCenter->getX(), -geoCenter->getY(), -geoCenter->getZ());
+  //! The rotation of the camera (window angles, in degrees) around geoCenter.
+  static Mat4 cameraRotation(Coordinate* geoCenter, double angleX, double angleY, double angleZ) {
     double radiansX = (angleX*M_PI)/180;
     double radiansY = (angleY*M_PI)/180;
     double radiansZ = (angleZ*M_PI)/180;
 
-    Matrix translation(Matrix::translation3DVectorToMatrix(geoCenter));
-
-    Matrix rotationMatrixX(Matrix::rotationXVectorToMatrix(radiansX));
-    Matrix rotationMatrixY(Matrix::rotationYVectorToMatrix(radiansY));
-    Matrix rotationMatrixZ(Matrix::rotationZVectorToMatrix(radiansZ));
+    Mat4 translation = Mat4::translation(geoCenter->getX(), geoCenter->getY(), geoCenter->getZ());
+    Mat4 translationInv = Mat4::translation(-geoCenter->getX(), -geoCenter->getY(), -geoCenter->getZ());
 
-    Matrix translationInv(Matrix::translation3DVectorToMatrix(&negRotationVector));
-
-    Matrix rotationMatrix = translation * rotationMatrixX * rotationMatrixY * rotationMatrixZ * translationInv;
-
-    vector<Coordinate*>::iterator it;
-    for(it = coordinates.begin(); it != coordinates.end(); it++) {
-      Matrix coord(Matrix::coordinate3DToMatrix(*it));
-
-      Matrix rotatedObject = rotationMatrix * coord;
-      //cout << coord.getMatrix()[0][0] << " " << coord.getMatrix()[1][0] << " " << coord.getMatrix()[2][0] << " --> " << rotatedObject.getMatrix()[0][0] << " " << rotatedObject.getMatrix()[1][0] << " " << rotatedObject.getMatrix()[2][0] << endl;
-      (*it)->setXop(rotatedObject.getMatrix()[0][0]);
-      (*it)->setYop(rotatedObject.getMatrix()[1][0]);
-      (*it)->setZop(rotatedObject.getMatrix()[2][0]);
-    }
+    return translation * Mat4::rotationX(radiansX) * Mat4::rotationY(radiansY)
+           * Mat4::rotationZ(radiansZ) * translationInv;
   }
 
-  static Matrix getRotationMatrix(double angle, int whichAxis) {
+  static Mat4 getRotationMatrix(double angle, int whichAxis) {
     switch (whichAxis) {
       case 1:
-        return Matrix::rotationXVectorToMatrix(angle);
-        break;
+        return Mat4::rotationX(angle);
       case 2:
-        return Matrix::rotationYVectorToMatrix(angle);
-        break;
+        return Mat4::rotationY(angle);
       case 3:
-        return Matrix::rotationZVectorToMatrix(angle);
-        break;
+        return Mat4::rotationZ(angle);
+      default:
+        return Mat4::identity();
     }
   }
 
@@ -1,7 +1,7 @@
 #ifndef OPP_HPP
 #define OPP_HPP
 
-#include "matrix.hpp"
+#include "fixedMatrix.hpp"
 #include "window.hpp"
 
 /*! Transform world coordinates to normalized system coordinates. */
@@ -15,19 +15,16 @@ public:
   ~Opp () {}
 
   void computeAngle(Window* window, Coordinate* vrp) {
-    Coordinate negCoord(-vrp->getX(), -vrp->getY(), -vrp->getZ());
-    Matrix trans = Matrix::translation3DVectorToMatrix(&negCoord);
+    Mat4 trans = Mat4::translation(-vrp->getX(), -vrp->getY(), -vrp->getZ());
 
     vector<Coordinate*> coordinates = window->getCoordinates();
     vector<Coordinate*>::iterator it;
     for(it = coordinates.begin(); it != coordinates.end(); it++) {
-      Matrix coord(Matrix::coordinate3DToMatrix(*it));
+      Vec4 translatedObject = trans * Vec4::point((*it)->getX(), (*it)->getY(), (*it)->getZ());
 
-      Matrix translatedObject = trans * coord;
-
-      (*it)->setXop(-translatedObject.getMatrix()[0][0]);
-      (*it)->setYop(-translatedObject.getMatrix()[1][0]);
-      (*it)->setZop(-translatedObject.getMatrix()[2][0]);
+      (*it)->setXop(-translatedObject[0]);
+      (*it)->setYop(-translatedObject[1]);
+      (*it)->setZop(-translatedObject[2]);
     }
 
     Coordinate* w1t = window->getCoordinates()[0];
@@ -47,24 +44,25 @@ public:
     w2t->setXop(w2t->getX()); w2t->setYop(w2t->getY()); w2t->setZop(w2t->getZ());
   }
 
-  void transformation(vector<Coordinate*> coord, Coordinate* geometriCenter) {
-    Coordinate negCoord(-geometriCenter->getX(), -geometriCenter->getY(), -geometriCenter->getZ());
+  //! The alignment of the world with the view plane normal (VPN).
+  Mat4 matrix(Coordinate* geometriCenter) {
+    Mat4 trans = Mat4::translation(-geometriCenter->getX(), -geometriCenter->getY(), -geometriCenter->getZ());
+    Mat4 rotx  = Mat4::rotationX(this->angleX);
+    Mat4 roty  = Mat4::rotationY(this->angleY);
 
-    Matrix trans = Matrix::translation3DVectorToMatrix(&negCoord);
-    Matrix rotx  = Matrix::rotationXVectorToMatrix(this->angleX);
-    Matrix roty  = Matrix::rotationYVectorToMatrix(this->angleY);
+    return trans * rotx * roty;
+  }
 
-    Matrix transform = trans * rotx * roty;
+  void transformation(const vector<Coordinate*> &coord, Coordinate* geometriCenter) {
+    Mat4 transform = matrix(geometriCenter);
 
-    vector<Coordinate*>::iterator it;
+    vector<Coordinate*>::const_iterator it;
     for(it = coord.begin(); it != coord.end(); it++) {
-        Matrix coord(Matrix::coordinate3DToMatrixOp((*it)));
-
-        Matrix translatedObject = transform * coord;
+        Vec4 translatedObject = transform * Vec4::point((*it)->getXop(), (*it)->getYop(), (*it)->getZop());
 
-        (*it)->setXop(translatedObject.getMatrix()[0][0]);
-        (*it)->setYop(translatedObject.getMatrix()[1][0]);
-        (*it)->setZop(translatedObject.getMatrix()[2][0]);
+        (*it)->setXop(translatedObject[0]);
+        (*it)->setYop(translatedObject[1]);
+        (*it)->setZop(translatedObject[2]);
     }
   }
 
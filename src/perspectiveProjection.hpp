@@ -1,7 +1,7 @@
 #ifndef PERSPECTIVE_HPP
 #define PERSPECTIVE_HPP
 
-#include "matrix.hpp"
+#include "fixedMatrix.hpp"
 #include "window.hpp"
 
 #include <iostream>
@@ -28,24 +28,20 @@ public:
   void computeAngle(Coordinate* geo, Coordinate* cop) {
     // Step 1 - Translade COP para a origem e o mundo
     // COP
-    Coordinate negCop(-cop->getX(), -cop->getY(), -cop->getZ());
-    Matrix translation(Matrix::translation3DVectorToMatrix(&negCop));
+    Mat4 translation = Mat4::translation(-cop->getX(), -cop->getY(), -cop->getZ());
 
-    Matrix coordCOP(Matrix::coordinate3DToMatrix(cop));
-    Matrix resultante = translation * coordCOP;
-    cop->setXop(resultante.getMatrix()[0][0]);
-    cop->setYop(resultante.getMatrix()[1][0]);
-    cop->setZop(resultante.getMatrix()[2][0]);
+    Vec4 resultante = translation * Vec4::point(cop->getX(), cop->getY(), cop->getZ());
+    cop->setXop(resultante[0]);
+    cop->setYop(resultante[1]);
+    cop->setZop(resultante[2]);
 
     // VPR
-    Coordinate negGeo(-geo->getX(), -geo->getY(), -geo->getZ());
-    Matrix translation2(Matrix::translation3DVectorToMatrix(&negGeo));
+    Mat4 translation2 = Mat4::translation(-geo->getX(), -geo->getY(), -geo->getZ());
 
-    Matrix coordGeo(Matrix::coordinate3DToMatrix(geo));
-    Matrix resultante2 = translation * translation2 * coordGeo;
-    geo->setXop(resultante2.getMatrix()[0][0]);
-    geo->setYop(resultante2.getMatrix()[1][0]);
-    geo->setZop(resultante2.getMatrix()[2][0]);
+    Vec4 resultante2 = translation * translation2 * Vec4::point(geo->getX(), geo->getY(), geo->getZ());
+    geo->setXop(resultante2[0]);
+    geo->setYop(resultante2[1]);
+    geo->setZop(resultante2[2]);
 
     // Step 2 - Determine VPN, angulos X e Y
     // Cross product
@@ -58,26 +54,42 @@ public:
     this->angleY = (x == 0 || z == 0) ? 0 : (atan(x/z)*M_PI)/180;
   }
 
-  void transformation(vector<Coordinate*> coord, Coordinate* vrp, Coordinate* cop) {
+  //! The alignment of the world with the VPN, with COP at the origin.
+  Mat4 alignment(Coordinate* vrp, Coordinate* cop) {
     // 3 - Rotacione o mundo em torno de X e Y de forma a alinhar VPN com o eixo Z
-    Coordinate negCoord(-vrp->getX(), -vrp->getY(), -vrp->getZ());
-    Coordinate negCop(-cop->getX(), -cop->getY(), -cop->getZ());
+    Mat4 copDistance = Mat4::translation(-cop->getX(), -cop->getY(), -cop->getZ());
+    Mat4 rotx  = Mat4::rotationX(-this->angleX);
+    Mat4 roty  = Mat4::rotationY(-this->angleY);
+    Mat4 trans = Mat4::translation(-vrp->getX(), -vrp->getY(), -vrp->getZ());
 
-    Matrix copDistance = Matrix::translation3DVectorToMatrix(&negCop);
-    Matrix rotx  = Matrix::rotationXVectorToMatrix(-this->angleX);
-    Matrix roty  = Matrix::rotationYVectorToMatrix(-this->angleY);
-    Matrix trans = Matrix::translation3DVectorToMatrix(&negCoord);
+    return trans * rotx * roty * copDistance;
+  }
+
+  //! The alignment followed by the projection onto the plane z = d.
+  /*!
+   * The result is homogeneous: dividing x and y by w gives the same
+   * point as intersection().
+   */
+  Mat4 matrix(Coordinate* vrp, Coordinate* cop) {
+    double d = cop->getZ();
+    Mat4 projection = {{{1, 0,  0 , 0},
+                        {0, 1,  0 , 0},
+                        {0, 0,  1 , 0},
+                        {0, 0, 1/d, 0}}};
+
+    return projection * alignment(vrp, cop);
+  }
 
-    Matrix transform = trans * rotx * roty * copDistance;
+  void transformation(const vector<Coordinate*> &coord, Coordinate* vrp, Coordinate* cop) {
+    Mat4 transform = alignment(vrp, cop);
 
-    vector<Coordinate*>::iterator it;
+    vector<Coordinate*>::const_iterator it;
     for(it = coord.begin(); it != coord.end(); it++) {
-        Matrix coord(Matrix::coordinate3DToMatrixOp((*it)));
-        Matrix translatedObject = transform * coord;
+        Vec4 translatedObject = transform * Vec4::point((*it)->getXop(), (*it)->getYop(), (*it)->getZop());
 
-        (*it)->setXop(translatedObject.getMatrix()[0][0]);
-        (*it)->setYop(translatedObject.getMatrix()[1][0]);
-        (*it)->setZop(translatedObject.getMatrix()[2][0]);
+        (*it)->setXop(translatedObject[0]);
+        (*it)->setYop(translatedObject[1]);
+        (*it)->setZop(translatedObject[2]);
 
         // Compute intersection
         Coordinate x = intersection(*it, cop->getZ());
@@ -8,11 +8,14 @@
 class Point: public GraphicObject2D {
 
 public:
-  Point(string name, vector<Coordinate*> &pointCoordinate) :
+  Point(string name, const vector<Coordinate> &pointCoordinate) :
     GraphicObject2D(name, POINT, pointCoordinate) {
 
 		}
 
+  Point(string name, CoordinateSpan pointCoordinate) :
+    GraphicObject2D(name, POINT, pointCoordinate) {}
+
 };
 
 #endif
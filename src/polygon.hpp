@@ -7,43 +7,30 @@
 
 class Polygon: public GraphicObject2D {
 private:
-	vector<Coordinate*> windowPoints;
+	FrameSpan<Vertex2D> windowPoints;  //!< The polygon clipped against the window, for the current frame.
 	bool filled;
-	bool visibility;
 
 public:
-	Polygon(string name, vector<Coordinate*> &polygonCoordinates, bool filled) :
-		GraphicObject2D(name, POLYGON, polygonCoordinates) {
+	Polygon(string name, const vector<Coordinate> &polygonCoordinates, bool filled) :
+		GraphicObject2D(name, POLYGON, polygonCoordinates), windowPoints{NULL, 0} {
 			this->filled = filled;
-			this->visibility = true;
-			this->windowPoints = {};
 	}
 
-	~Polygon() {
-		vector<Coordinate*>::iterator it;
-		for(it = windowPoints.begin(); it != windowPoints.end(); it++) {
-			delete *it;
-		}
-	}
-
-	void setVisibility(bool updateVisibility) {
-		this->visibility = updateVisibility;
-	}
-
-	bool isVisible() {
-		return this->visibility;
+	Polygon(string name, CoordinateSpan polygonCoordinates, bool filled) :
+		GraphicObject2D(name, POLYGON, polygonCoordinates), windowPoints{NULL, 0} {
+			this->filled = filled;
 	}
 
 	bool fill() {
 		return filled;
 	}
 
-	void updateWindowPoints(vector<Coordinate*> newPoints) {
-		this->windowPoints = newPoints;
+	FrameSpan<Vertex2D> getWindowPoints() {
+		return this->windowPoints;
 	}
 
-	vector<Coordinate*> getWindowPoints() {
-		return this->windowPoints;
+	void setWindowPoints(FrameSpan<Vertex2D> points) {
+		this->windowPoints = points;
 	}
 
 };
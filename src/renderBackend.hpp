@@ -0,0 +1,49 @@
+#ifndef RENDERBACKEND_HPP
+#define RENDERBACKEND_HPP
+
+#include <vector>
+
+#include "vertexBuffer.hpp"
+
+using namespace std;
+
+//! Where the Drawer puts the pixels of a frame.
+/*!
+ * The Drawer batches the geometry of a frame and hands it over in a few
+ * calls between clear() and flush(). Coordinates are in pixels (viewport
+ * coordinates), colors are RGB in [0, 1].
+ *
+ * Showing the frame is up to each backend (@see CairoBackend::present()),
+ * so this interface and the backends without a window need no GTK.
+ */
+class RenderBackend {
+public:
+  virtual ~RenderBackend() {}
+
+  //! Reallocates the target to 'width' x 'height' pixels.
+  virtual void resize(int width, int height) = 0;
+
+  //! Paints the whole target with the given color.
+  virtual void clear(double r, double g, double b) = 0;
+
+  virtual void setColor(double r, double g, double b) = 0;
+
+  //! Fills the (closed) polygon 'points' with the current color.
+  virtual void fillPolygon(PointSpan points) = 0;
+
+  //! Marks each of 'points' as a dot with the current color.
+  virtual void fillPoints(PointSpan points) = 0;
+
+  //! Strokes polylines stored back to back in 'points' with the current color.
+  /*!
+   * @param runs Number of points of each polyline.
+   * @param closed Whether each polyline is closed (last point joins the first).
+   */
+  virtual void strokePolylines(PointSpan points, const vector<size_t> &runs,
+      const vector<bool> &closed) = 0;
+
+  //! Finishes the frame (nothing drawn may be visible before that).
+  virtual void flush() {}
+};
+
+#endif  //!< RENDERBACKEND_HPP
@@ -0,0 +1,65 @@
+#ifndef RENDERTHREAD_HPP
+#define RENDERTHREAD_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+//! Renders frames on a thread of its own, on request.
+/*!
+ * request() only flags that the scene changed and returns at once.
+ * Requests made while a frame is being rendered are coalesced: however
+ * many arrive, a single new frame follows, and it sees the latest state.
+ */
+class RenderThread {
+private:
+  function<void()> renderFrame;
+  mutex lock;
+  condition_variable wake;
+  bool pending;   //!< A frame was requested since the last one started.
+  bool stopping;
+  thread worker;  //!< Declared last: started once the rest is initialized.
+
+  void loop() {
+    while (true) {
+      {
+        unique_lock<mutex> guard(lock);
+        wake.wait(guard, [this] { return pending || stopping; });
+        if (stopping)
+          return;
+        pending = false;
+      }
+
+      renderFrame();
+    }
+  }
+
+public:
+  //! @param renderFrame Renders one frame of the current state of the scene.
+  RenderThread(function<void()> renderFrame) : renderFrame(renderFrame),
+      pending(false), stopping(false), worker(&RenderThread::loop, this) {}
+
+  //! Finishes the frame being rendered, if any, and stops the thread.
+  ~RenderThread() {
+    {
+      lock_guard<mutex> guard(lock);
+      stopping = true;
+    }
+    wake.notify_one();
+    worker.join();
+  }
+
+  //! Asks for a new frame.
+  void request() {
+    {
+      lock_guard<mutex> guard(lock);
+      pending = true;
+    }
+    wake.notify_one();
+  }
+};
+
+#endif  //!< RENDERTHREAD_HPP
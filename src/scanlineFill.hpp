@@ -0,0 +1,149 @@
+#ifndef SCANLINEFILL_HPP
+#define SCANLINEFILL_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <math.h>
+#include <vector>
+
+#include "vertexBuffer.hpp"
+
+using namespace std;
+
+#define SCANLINE_FRACTION_BITS 16
+#define SCANLINE_ONE (1 << SCANLINE_FRACTION_BITS)
+
+//! Polygon fill by scanlines, with an edge table and an active edge list.
+/*!
+ * Pixels are filled when their center is inside the polygon under the
+ * nonzero winding rule. Edges are bucketed by the first row they cross
+ * (the edge table); the active edge list holds the edges crossing the
+ * current row, with x kept in 16.16 fixed point and advanced by one
+ * addition per row. Spans are handed to a callback, so the engine does not
+ * know about the framebuffer.
+ *
+ * Tables are kept between polygons: once they have grown to fit the
+ * largest polygon, filling does not allocate. Coordinates must fit the
+ * fixed point range (|x| < 32768), which clipped viewport points do.
+ */
+class ScanlineFill {
+private:
+  struct Edge {
+    int32_t x;       //!< x - 0.5 where the edge crosses the center of the current row.
+    int32_t dx;      //!< Change of x from one row to the next.
+    int32_t endRow;  //!< First row the edge no longer crosses.
+    int32_t winding; //!< +1 going down, -1 going up.
+    int32_t next;    //!< Next edge starting at the same row, -1 at the end.
+  };
+
+  vector<Edge> edges;
+  vector<int32_t> rowHead;  //!< First edge starting at each row, -1 if none.
+  vector<Edge> active;
+
+  static int32_t toFixed(double v) {
+    return (int32_t) lround(v * SCANLINE_ONE);
+  }
+
+  //! The smallest integer >= v, for v in fixed point.
+  static int32_t ceilFixed(int32_t v) {
+    return (v + SCANLINE_ONE - 1) >> SCANLINE_FRACTION_BITS;
+  }
+
+  //! Keeps 'active' sorted by x (it is almost sorted from the previous row).
+  void sortActive() {
+    for (size_t i = 1; i < active.size(); i++) {
+      Edge e = active[i];
+      size_t j = i;
+      for (; j > 0 && active[j-1].x > e.x; j--)
+        active[j] = active[j-1];
+      active[j] = e;
+    }
+  }
+
+public:
+  //! Fills 'polygon' (closed, in pixels) clipped to rows [0, height).
+  /*!
+   * @param span Called as span(y, x0, x1) for the pixels [x0, x1) of row y,
+   *    left to right within a row and top to bottom; x0 < x1, not clipped
+   *    horizontally.
+   */
+  template <typename SpanFunction>
+  void fill(PointSpan polygon, int height, SpanFunction span) {
+    size_t n = polygon.size();
+    if (n < 3 || height <= 0)
+      return;
+
+    double minY = polygon[0].y, maxY = polygon[0].y;
+    for (size_t i = 1; i < n; i++) {
+      minY = min(minY, polygon[i].y);
+      maxY = max(maxY, polygon[i].y);
+    }
+
+    // Rows whose center (y + 0.5) lies in [minY, maxY)
+    int32_t firstRow = max(0, (int32_t) ceil(minY - 0.5));
+    int32_t lastRow = min(height, (int32_t) ceil(maxY - 0.5));
+    if (firstRow >= lastRow)
+      return;
+
+    // Edge table
+    if (rowHead.size() < (size_t) height)
+      rowHead.resize(height);
+    fill_n(rowHead.begin() + firstRow, lastRow - firstRow, -1);
+
+    edges.clear();
+    for (size_t i = 0; i < n; i++) {
+      const Vertex2D* a = &polygon[i];
+      const Vertex2D* b = &polygon[(i + 1) % n];
+      int32_t winding = 1;
+      if (a->y > b->y) {
+        swap(a, b);
+        winding = -1;
+      }
+
+      int32_t startRow = max(0, (int32_t) ceil(a->y - 0.5));
+      int32_t endRow = min(height, (int32_t) ceil(b->y - 0.5));
+      if (startRow >= endRow)
+        continue;  // horizontal, or between two row centers
+
+      double slope = (b->x - a->x) / (b->y - a->y);
+      double x = a->x + (startRow + 0.5 - a->y) * slope;
+      edges.push_back({toFixed(x - 0.5), toFixed(slope), endRow, winding, rowHead[startRow]});
+      rowHead[startRow] = edges.size() - 1;
+    }
+
+    // Active edge list, row by row
+    active.clear();
+    for (int32_t y = firstRow; y < lastRow; y++) {
+      size_t kept = 0;
+      for (size_t i = 0; i < active.size(); i++) {
+        if (active[i].endRow > y)
+          active[kept++] = active[i];
+      }
+      active.resize(kept);
+
+      for (int32_t e = rowHead[y]; e != -1; e = edges[e].next)
+        active.push_back(edges[e]);
+      sortActive();
+
+      // One span for each run of edges enclosing nonzero winding
+      int32_t winding = 0, spanStart = 0;
+      for (size_t i = 0; i < active.size(); i++) {
+        int32_t before = winding;
+        winding += active[i].winding;
+
+        if (before == 0 && winding != 0) {
+          spanStart = ceilFixed(active[i].x);
+        } else if (before != 0 && winding == 0) {
+          int32_t spanEnd = ceilFixed(active[i].x);
+          if (spanStart < spanEnd)
+            span(y, spanStart, spanEnd);
+        }
+      }
+
+      for (size_t i = 0; i < active.size(); i++)
+        active[i].x += active[i].dx;
+    }
+  }
+};
+
+#endif  //!< SCANLINEFILL_HPP
@@ -0,0 +1,495 @@
+#ifndef SCENEFILE_HPP
+#define SCENEFILE_HPP
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+#include "bezierCurve.hpp"
+#include "bezierSurface.hpp"
+#include "bspline.hpp"
+#include "bsplineSurface.hpp"
+#include "line.hpp"
+#include "mesh3D.hpp"
+#include "object3D.hpp"
+#include "point.hpp"
+#include "polygon.hpp"
+#include "surface.hpp"
+
+using namespace std;
+
+#define SCENE_FILE_VERSION 3
+#define SCENE_FILE_EXTENSION ".scene"
+#define SCENE_FILLED 1  //!< SceneRecord flag of filled polygons.
+
+//! First bytes of a scene file.
+struct SceneHeader {
+  char magic[8];         //!< "GRSCENE".
+  uint32_t version;      //!< SCENE_FILE_VERSION.
+  uint32_t objectCount;
+  uint64_t vertexCount;  //!< Length of each of the x, y and z arrays.
+  uint64_t indexCount;   //!< Length of the index array.
+  uint64_t nameBytes;    //!< Length of the name array.
+};
+
+//! How an object of a scene file is rebuilt from the arrays.
+/*!
+ * The index buffers of an object follow each other in the index array,
+ * holding vertex indexes relative to its first vertex:
+ * - OBJECT3D: two indexes per segment;
+ * - MESH3D: edges, faces and face sizes (@see Mesh3D);
+ * - SURFACE: the rows and columns of each sample grid (@see SampleGrid).
+ *
+ * The vertices of a curve or surface with control points (a 'basis' other
+ * than TESSELLATED) are its control points, the grid of a surface row after
+ * row, and it has no indexes.
+ */
+struct SceneRecord {
+  uint32_t type;         //!< A Type.
+  uint32_t flags;
+  uint32_t basis;           //!< A Basis, for curves and surfaces.
+  uint32_t controlColumns;  //!< Points of each row of the control grid of a surface.
+  uint64_t nameOffset;
+  uint64_t nameLength;
+  uint64_t firstVertex;
+  uint64_t vertexCount;
+  uint64_t firstIndex;
+  uint64_t indexCounts[3];  //!< Length of each index buffer of the object.
+  double delta;             //!< Largest parameter step of a B-spline curve (@see BSpline).
+};
+
+//! Saves and loads the display file in a binary format.
+/*!
+ * A scene file is a SceneHeader followed by flat arrays, each starting at a
+ * multiple of 8 bytes:
+ *
+ *     SceneRecord records[objectCount]
+ *     double x[vertexCount], y[vertexCount], z[vertexCount]
+ *     uint32_t indexes[indexCount]
+ *     char names[nameBytes]
+ *
+ * The vertex arrays have the layout of the VertexBuffer, so loading is a
+ * memory mapping and a copy of each array into place: nothing is parsed.
+ * Numbers are stored in the byte order of the machine that wrote the file.
+ *
+ * Bezier and B-spline curves and surfaces are stored as their control
+ * points and rebuilt on load, tessellated at level 0 until the renderer
+ * picks their level (@see LevelOfDetail). Curves and surfaces without
+ * control points are stored as their points.
+ */
+class SceneFile {
+private:
+  //! Where the arrays of a file with 'header' begin.
+  struct Layout {
+    size_t records, x, y, z, indexes, names, size;
+
+    Layout(const SceneHeader& header) {
+      records = sizeof(SceneHeader);
+      x = records + header.objectCount * sizeof(SceneRecord);
+      y = x + header.vertexCount * sizeof(double);
+      z = y + header.vertexCount * sizeof(double);
+      indexes = z + header.vertexCount * sizeof(double);
+      names = align(indexes + header.indexCount * sizeof(uint32_t));
+      size = names + header.nameBytes;
+    }
+  };
+
+  static size_t align(size_t offset) {
+    return (offset + 7) & ~(size_t) 7;
+  }
+
+  static bool hasIndexesBelow(const uint32_t* indexes, size_t count, uint64_t limit) {
+    for (size_t i = 0; i < count; i++) {
+      if (indexes[i] >= limit)
+        return false;
+    }
+    return true;
+  }
+
+  //! Writes all of 'parts', however many calls it takes.
+  static bool writeAll(int fd, struct iovec* parts, int count) {
+    while (count > 0) {
+      ssize_t written = writev(fd, parts, count);
+      if (written < 0) {
+        if (errno == EINTR)
+          continue;
+        return false;
+      }
+
+      // Skip what was written, resuming inside a part if needed
+      while (count > 0 && (size_t) written >= parts->iov_len) {
+        written -= parts->iov_len;
+        parts++;
+        count--;
+      }
+      if (count > 0) {
+        parts->iov_base = (char*) parts->iov_base + written;
+        parts->iov_len -= written;
+      }
+    }
+    return true;
+  }
+
+  //! The control points of 'object', if it is stored as such; its basis and grid go to 'record'.
+  static const vector<Coordinate>* controlPointsOf(GraphicObject* object, SceneRecord& record) {
+    record.basis = TESSELLATED;
+    record.controlColumns = 0;
+    record.delta = 0;
+    if (object->getType() == CURVE) {
+      Curve* curve = static_cast<Curve*>(object);
+      record.basis = curve->getBasis();
+      if (record.basis == BSPLINE)
+        record.delta = static_cast<BSpline*>(curve)->getDelta();
+      return record.basis == TESSELLATED ? NULL : &curve->getControlPoints();
+    }
+    if (object->getType() == SURFACE) {
+      Surface* surface = static_cast<Surface*>(object);
+      record.basis = surface->getBasis();
+      record.controlColumns = surface->getControlColumns();
+      return record.basis == TESSELLATED ? NULL : &surface->getControlPoints();
+    }
+    return NULL;
+  }
+
+  //! The points of a record with control points, as given to the constructors.
+  static vector<Coordinate> coordinates(CoordinateSpan points, size_t first, size_t count) {
+    vector<Coordinate> coordinates;
+    coordinates.reserve(count);
+    for (size_t i = first; i < first + count; i++) {
+      coordinates.push_back(Coordinate(points.x[i], points.y[i], points.z[i]));
+    }
+    return coordinates;
+  }
+
+  //! The index buffers of 'object', appended to 'indexes'.
+  static void appendIndexes(GraphicObject* object, vector<uint32_t>& indexes, SceneRecord& record) {
+    switch (object->getType()) {
+      case OBJECT3D: {
+        vector<Segment>& segments = static_cast<Object3D*>(object)->getSegmentList();
+        for (const Segment& segment : segments) {
+          indexes.push_back(segment.getA());
+          indexes.push_back(segment.getB());
+        }
+        record.indexCounts[0] = 2 * segments.size();
+        break;
+      }
+      case MESH3D: {
+        Mesh3D* mesh = static_cast<Mesh3D*>(object);
+        const vector<uint32_t>* buffers[3] = {&mesh->getEdges(), &mesh->getFaces(), &mesh->getFaceSizes()};
+        for (int i = 0; i < 3; i++) {
+          indexes.insert(indexes.end(), buffers[i]->begin(), buffers[i]->end());
+          record.indexCounts[i] = buffers[i]->size();
+        }
+        break;
+      }
+      case SURFACE: {
+        if (record.basis != TESSELLATED)
+          break;
+        const vector<SampleGrid>& grids = static_cast<Surface*>(object)->getGrids();
+        for (const SampleGrid& grid : grids) {
+          indexes.push_back(grid.rows);
+          indexes.push_back(grid.columns);
+        }
+        record.indexCounts[0] = 2 * grids.size();
+        break;
+      }
+      default:
+        break;
+    }
+  }
+
+  //! Checks that the arrays of 'record' lie inside those of 'header'.
+  static bool inBounds(const SceneRecord& record, const SceneHeader& header) {
+    uint64_t indexes = 0;
+    for (int i = 0; i < 3; i++) {
+      if (record.indexCounts[i] > header.indexCount)
+        return false;
+      indexes += record.indexCounts[i];
+    }
+    return record.firstVertex <= header.vertexCount
+        && record.vertexCount <= header.vertexCount - record.firstVertex
+        && record.firstIndex <= header.indexCount
+        && indexes <= header.indexCount - record.firstIndex
+        && record.nameOffset <= header.nameBytes
+        && record.nameLength <= header.nameBytes - record.nameOffset;
+  }
+
+  //! Checks that the object of 'record' can be built (@see instantiate()).
+  /*!
+   * Besides lying inside the file, each object needs the points of its
+   * type (one for a point, two for a line, three for a polygon, two for a
+   * curve, four control points for a Bezier or B-spline curve) and the
+   * index buffers it is made of: the segments of an OBJECT3D, the edges or
+   * faces of a MESH3D and the sample grids of a SURFACE.
+   */
+  static bool isValid(const SceneRecord& record, const SceneHeader& header, const char* data, const Layout& layout) {
+    if (!inBounds(record, header))
+      return false;
+
+    if (record.basis > BSPLINE || (record.basis != TESSELLATED && record.type != CURVE && record.type != SURFACE))
+      return false;
+
+    const uint32_t* indexes = (const uint32_t*) (data + layout.indexes) + record.firstIndex;
+    switch (record.type) {
+      case POINT:
+        return record.vertexCount == 1;
+      case LINE:
+        return record.vertexCount == 2;
+      case POLYGON:
+        return record.vertexCount >= 3;
+      case CURVE:
+        return record.vertexCount >= (record.basis == TESSELLATED ? 2 : 4);
+      case OBJECT3D:
+        return record.indexCounts[0] > 0 && record.indexCounts[0] % 2 == 0
+            && hasIndexesBelow(indexes, record.indexCounts[0], record.vertexCount);
+      case MESH3D: {
+        const uint32_t* faceSizes = indexes + record.indexCounts[0] + record.indexCounts[1];
+        uint64_t corners = 0;
+        for (size_t i = 0; i < record.indexCounts[2]; i++) {
+          corners += faceSizes[i];
+        }
+        return (record.indexCounts[0] > 0 || record.indexCounts[2] > 0)
+            && record.indexCounts[0] % 2 == 0 && corners == record.indexCounts[1]
+            && hasIndexesBelow(indexes, record.indexCounts[0] + record.indexCounts[1], record.vertexCount);
+      }
+      case SURFACE: {
+        if (record.basis != TESSELLATED) {
+          return record.controlColumns >= 4 && record.vertexCount % record.controlColumns == 0
+              && record.vertexCount / record.controlColumns >= 4
+              && record.indexCounts[0] == 0 && record.indexCounts[1] == 0 && record.indexCounts[2] == 0;
+        }
+        uint64_t total = 0;
+        for (size_t i = 0; i + 1 < record.indexCounts[0]; i += 2) {
+          if (indexes[i] == 0 || indexes[i + 1] == 0)
+            return false;
+          total += (uint64_t) indexes[i] * indexes[i + 1];
+        }
+        return record.indexCounts[0] > 0 && record.indexCounts[0] % 2 == 0 && total <= record.vertexCount;
+      }
+      default:
+        return false;
+    }
+  }
+
+  //! Builds the object of a valid 'record' (@see isValid()).
+  static GraphicObject* instantiate(const SceneRecord& record, const char* data, const Layout& layout) {
+    const uint32_t* indexes = (const uint32_t*) (data + layout.indexes) + record.firstIndex;
+    string name(data + layout.names + record.nameOffset, record.nameLength);
+    CoordinateSpan points = {(const double*) (data + layout.x) + record.firstVertex,
+                             (const double*) (data + layout.y) + record.firstVertex,
+                             (const double*) (data + layout.z) + record.firstVertex,
+                             record.vertexCount};
+
+    switch (record.type) {
+      case POINT:
+        return new Point(name, points);
+      case LINE:
+        return new Line(name, points);
+      case POLYGON:
+        return new Polygon(name, points, record.flags & SCENE_FILLED);
+      case CURVE:
+        if (record.basis == BEZIER)
+          return new BezierCurve(name, coordinates(points, 0, points.count), LevelOfDetail::tolerance(0));
+        if (record.basis == BSPLINE)
+          return new BSpline(name, coordinates(points, 0, points.count), record.delta, LevelOfDetail::tolerance(0));
+        return new Curve(name, points);
+      case OBJECT3D: {
+        vector<Segment> segments;
+        segments.reserve(record.indexCounts[0] / 2);
+        for (size_t i = 0; i < record.indexCounts[0]; i += 2) {
+          segments.push_back(Segment(indexes[i], indexes[i + 1]));
+        }
+        return new Object3D(name, points, move(segments));
+      }
+      case MESH3D: {
+        const uint32_t* faces = indexes + record.indexCounts[0];
+        const uint32_t* faceSizes = faces + record.indexCounts[1];
+        return new Mesh3D(name, points,
+            vector<uint32_t>(indexes, faces),
+            vector<uint32_t>(faces, faceSizes),
+            vector<uint32_t>(faceSizes, faceSizes + record.indexCounts[2]));
+      }
+      default: {
+        if (record.basis != TESSELLATED) {
+          vector<vector<Coordinate> > grid;
+          for (size_t first = 0; first < points.count; first += record.controlColumns) {
+            grid.push_back(coordinates(points, first, record.controlColumns));
+          }
+          if (record.basis == BEZIER)
+            return new BezierSurface(name, grid, LevelOfDetail::tolerance(0));
+          return new BSplineSurface(name, grid, LevelOfDetail::tolerance(0));
+        }
+        vector<size_t> gridSizes(indexes, indexes + record.indexCounts[0]);
+        return new Surface(name, points, gridSizes);
+      }
+    }
+  }
+
+  static vector<GraphicObject*> parse(const char* data, size_t size, string fileName) {
+    SceneHeader header;
+    if (size < sizeof(header)) {
+      std::cerr << fileName << " is not a scene file" << std::endl;
+      return {};
+    }
+    memcpy(&header, data, sizeof(header));
+    if (memcmp(header.magic, "GRSCENE", 8) != 0) {
+      std::cerr << fileName << " is not a scene file" << std::endl;
+      return {};
+    }
+    if (header.version != SCENE_FILE_VERSION) {
+      std::cerr << fileName << " has scene file version " << header.version
+                << ", expected " << SCENE_FILE_VERSION << std::endl;
+      return {};
+    }
+
+    // Sizes are checked before computing offsets from them, so these cannot overflow
+    uint64_t limit = size / sizeof(uint32_t);
+    if (header.objectCount > limit || header.vertexCount > limit || header.indexCount > limit
+        || header.nameBytes > size || Layout(header).size != size) {
+      std::cerr << fileName << " is truncated or corrupted" << std::endl;
+      return {};
+    }
+
+    // Every object is checked first: a corrupted file adds nothing to the scene
+    Layout layout(header);
+    const SceneRecord* records = (const SceneRecord*) (data + layout.records);
+    for (uint32_t i = 0; i < header.objectCount; i++) {
+      if (!isValid(records[i], header, data, layout)) {
+        std::cerr << fileName << ": object " << i << " is corrupted" << std::endl;
+        return {};
+      }
+    }
+
+    vector<GraphicObject*> objs;
+    objs.reserve(header.objectCount);
+    for (uint32_t i = 0; i < header.objectCount; i++) {
+      objs.push_back(instantiate(records[i], data, layout));
+    }
+    return objs;
+  }
+
+public:
+  //! Checks whether 'fileName' names a scene file, by its extension.
+  static bool handles(string fileName) {
+    string extension = SCENE_FILE_EXTENSION;
+    return fileName.size() >= extension.size()
+        && fileName.compare(fileName.size() - extension.size(), extension.size(), extension) == 0;
+  }
+
+  //! Writes 'objs' to the scene file 'fileName'.
+  /*!
+   * The arrays are gathered in memory first and written with a single
+   * writev() call in the usual case.
+   * @return false if the file could not be written.
+   */
+  bool write(const vector<GraphicObject*> &objs, string fileName) {
+    VertexBuffer& buffer = VertexBuffer::scene();
+    SceneHeader header = {{'G', 'R', 'S', 'C', 'E', 'N', 'E', '\0'}, SCENE_FILE_VERSION,
+                          (uint32_t) objs.size(), 0, 0, 0};
+    vector<SceneRecord> records(objs.size());
+    vector<const vector<Coordinate>*> controlPoints(objs.size());
+    for (size_t i = 0; i < objs.size(); i++) {
+      controlPoints[i] = controlPointsOf(objs[i], records[i]);
+      records[i].firstVertex = header.vertexCount;
+      records[i].vertexCount = controlPoints[i] ? controlPoints[i]->size() : objs[i]->getVertices().count;
+      header.vertexCount += records[i].vertexCount;
+    }
+
+    vector<double> x(header.vertexCount), y(header.vertexCount), z(header.vertexCount);
+    vector<uint32_t> indexes;
+    string names;
+    for (size_t i = 0; i < objs.size(); i++) {
+      GraphicObject* object = objs[i];
+      SceneRecord& record = records[i];
+      if (controlPoints[i]) {
+        for (size_t j = 0; j < record.vertexCount; j++) {
+          const Coordinate& point = (*controlPoints[i])[j];
+          x[record.firstVertex + j] = point.getX();
+          y[record.firstVertex + j] = point.getY();
+          z[record.firstVertex + j] = point.getZ();
+        }
+      } else {
+        buffer.copyWorld(object->getVertices(), &x[record.firstVertex], &y[record.firstVertex], &z[record.firstVertex]);
+      }
+
+      record.type = object->getType();
+      record.flags = object->getType() == POLYGON && static_cast<Polygon*>(object)->fill() ? SCENE_FILLED : 0;
+      record.nameOffset = names.size();
+      record.nameLength = object->getObjectName().size();
+      names += object->getObjectName();
+
+      record.firstIndex = indexes.size();
+      record.indexCounts[0] = record.indexCounts[1] = record.indexCounts[2] = 0;
+      appendIndexes(object, indexes, record);
+    }
+    header.indexCount = indexes.size();
+    header.nameBytes = names.size();
+
+    Layout layout(header);
+    char padding[8] = {};
+    size_t vertexBytes = header.vertexCount * sizeof(double);
+    struct iovec parts[] = {
+      {&header, sizeof(header)},
+      {records.data(), records.size() * sizeof(SceneRecord)},
+      {x.data(), vertexBytes},
+      {y.data(), vertexBytes},
+      {z.data(), vertexBytes},
+      {indexes.data(), indexes.size() * sizeof(uint32_t)},
+      {padding, layout.names - (layout.indexes + indexes.size() * sizeof(uint32_t))},
+      {(void*) names.data(), names.size()}
+    };
+
+    int fd = open(fileName.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) {
+      std::cerr << "Cannot write " << fileName << std::endl;
+      return false;
+    }
+    bool written = writeAll(fd, parts, sizeof(parts) / sizeof(parts[0]));
+    if (close(fd) != 0 || !written) {
+      std::cerr << "Cannot write " << fileName << std::endl;
+      return false;
+    }
+    return true;
+  }
+
+  //! Reads the objects of the scene file 'fileName'.
+  /*!
+   * @return No objects if the file cannot be read or is not a valid scene file.
+   */
+  vector<GraphicObject*> read(string fileName) {
+    int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+      std::cerr << "Cannot read " << fileName << std::endl;
+      return {};
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+      close(fd);
+      std::cerr << "Cannot read " << fileName << std::endl;
+      return {};
+    }
+
+    void* data = mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+      std::cerr << "Cannot read " << fileName << std::endl;
+      return {};
+    }
+    madvise(data, info.st_size, MADV_SEQUENTIAL);
+
+    vector<GraphicObject*> objs = parse((const char*) data, info.st_size, fileName);
+    munmap(data, info.st_size);
+    return objs;
+  }
+};
+
+#endif  //!< SCENEFILE_HPP
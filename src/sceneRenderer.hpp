@@ -0,0 +1,266 @@
+#ifndef SCENERENDERER_HPP
+#define SCENERENDERER_HPP
+
+#include <memory>
+#include <vector>
+
+#include "clipping.hpp"
+#include "drawer.hpp"
+#include "enum.hpp"
+#include "levelOfDetail.hpp"
+#include "mesh3D.hpp"
+#include "object3D.hpp"
+#include "point.hpp"
+#include "viewPipeline.hpp"
+#include "workerPool.hpp"
+
+using namespace std;
+
+//! Takes the objects of a frame from world coordinates to the Drawer.
+/*!
+ * Each object is projected, clipped and mapped to the viewport with the
+ * matrices of 'pipeline' (@see ViewPipeline::update()), then drawn. Objects
+ * keep their viewport points until they or the frame matrices change.
+ *
+ * The geometry of different objects is independent, so it is computed in
+ * parallel on the WorkerPool, each participant with its own Clipping (which
+ * keeps scratch buffers). Only the Drawer calls run on the calling thread,
+ * in the order of the objects.
+ *
+ * The clipped points of the objects are bump allocated from the FrameArena
+ * of each Clipping. The arenas are reset, all at once, when the frame
+ * matrices change, since every object is clipped again then anyway. They
+ * are also reset when objects changed under the same matrices have grown
+ * them to twice their size after the last reset; every object is then
+ * clipped again. Objects are cached per arena generation, so an object
+ * never keeps points from a reset arena.
+ */
+class SceneRenderer {
+private:
+  ViewPipeline& pipeline;
+  Drawer& drawer;
+  WorkerPool& pool;
+  vector<unique_ptr<Clipping>> clippers;  //!< One per participant of 'pool'.
+  vector<GraphicObject*> stale;           //!< Objects to update in the current frame.
+  size_t generation;                      //!< Incremented on each reset of the arenas.
+  size_t arenaVersion;                    //!< Frame version of the last reset.
+  size_t arenaBudget;                     //!< Bytes the arenas may hold before a reset.
+
+  size_t arenaBytes() {
+    size_t bytes = 0;
+    for (unique_ptr<Clipping>& clipping : clippers)
+      bytes += clipping->getArena().allocated();
+    return bytes;
+  }
+
+  //! Releases the clipped points of every object, which have to be clipped again.
+  void resetArenas() {
+    for (unique_ptr<Clipping>& clipping : clippers)
+      clipping->getArena().reset();
+    generation++;
+  }
+
+  //! Transforms the world coordinates of 'elem' into normalized coordinates.
+  void project(GraphicObject* elem) {
+    Coordinate geoCenter = elem->getGeometricCenter();
+    elem->setWindowBounds(pipeline.project(elem->getVertices(), pipeline.objectMatrix(&geoCenter)));
+  }
+
+  //! Transforms the clipped points of 'object' into viewport coordinates.
+  void toViewport(GraphicObject* object) {
+    switch (object->getType()) {
+      case POLYGON:
+        pipeline.toViewport(static_cast<Polygon*>(object)->getWindowPoints());
+        break;
+      case CURVE:
+        pipeline.toViewport(static_cast<Curve*>(object)->getWindowPoints());
+        break;
+      case OBJECT3D:
+        pipeline.toViewport(static_cast<Object3D*>(object)->getWindowSegments());
+        break;
+      case MESH3D:
+        pipeline.toViewport(static_cast<Mesh3D*>(object)->getWindowSegments());
+        break;
+      case SURFACE:
+        pipeline.toViewport(static_cast<Surface*>(object)->getWindowPoints());
+        break;
+      default:
+        pipeline.toViewport(object->getVertices());
+        break;
+    }
+  }
+
+  //! Draws segments given as pairs of viewport points.
+  void drawSegments(FrameSpan<Vertex2D> points) {
+    for (size_t i = 0; i + 1 < points.size(); i += 2) {
+      drawer.drawLine(points[i].x, points[i].y, points[i+1].x, points[i+1].y);
+    }
+  }
+
+public:
+  SceneRenderer(ViewPipeline& pipeline, Drawer& drawer, WorkerPool& pool = WorkerPool::shared()) :
+      pipeline(pipeline), drawer(drawer), pool(pool), generation(1), arenaVersion(0),
+      arenaBudget(0) {
+    for (unsigned i = 0; i < pool.size(); i++)
+      clippers.emplace_back(new Clipping());
+  }
+
+  //! Draws 'objects' into the open frame of the Drawer.
+  /*!
+   * @param lineAlgorithm The line clipping algorithm (@see Clipping::lineClipping()).
+   */
+  void render(const vector<GraphicObject*> &objects, int lineAlgorithm) {
+    bool reset = pipeline.getVersion() != arenaVersion || arenaBytes() > arenaBudget;
+    if (reset) {
+      resetArenas();
+      arenaVersion = pipeline.getVersion();
+    }
+    size_t version = generation;
+
+    stale.clear();
+    for (GraphicObject* element : objects) {
+      if (!element->isCached(version))
+        stale.push_back(element);
+    }
+
+    // Small chunks, so the participants can even out objects of very different sizes
+    pool.parallelFor(stale.size(), 16, [&](size_t begin, size_t end, unsigned participant) {
+      for (size_t i = begin; i < end; i++) {
+        update(stale[i], *clippers[participant], lineAlgorithm);
+        stale[i]->setCacheVersion(version);
+      }
+    });
+
+    if (reset)
+      arenaBudget = 2 * arenaBytes() + FRAME_ARENA_BLOCK_SIZE;
+
+    for (GraphicObject* element : objects) {
+      if (element->isVisible())
+        draw(element);
+    }
+  }
+
+  //! Re-tessellates 'element', a curve or surface, if its level of detail changed.
+  /*!
+   * The level follows the size of its control hull on the viewport, with
+   * the matrices of the current frame. Changes the vertices of the object:
+   * not to be called while a frame is being computed.
+   *
+   * @return true if the vertices of 'element' changed.
+   */
+  bool updateLevelOfDetail(GraphicObject* element) {
+    switch (element->getType()) {
+      case CURVE: {
+        Curve* curve = static_cast<Curve*>(element);
+        if (curve->getControlPoints().empty())
+          return false;
+
+        Coordinate geoCenter = curve->getGeometricCenter();
+        double scale = pipeline.pixelsPerUnit(curve->getControlPoints(), &geoCenter);
+        return curve->setLevel(LevelOfDetail::level(scale));
+      }
+      case SURFACE: {
+        Surface* surface = static_cast<Surface*>(element);
+        if (surface->getControlPoints().empty())
+          return false;
+
+        Coordinate geoCenter = surface->getGeometricCenter();
+        double scale = pipeline.pixelsPerUnit(surface->getControlPoints(), &geoCenter);
+        return surface->setLevel(LevelOfDetail::level(scale));
+      }
+      default:
+        return false;
+    }
+  }
+
+  //! Projects, clips and maps 'element' to the viewport, setting its visibility.
+  void update(GraphicObject* element, Clipping& clipping, int lineAlgorithm) {
+    project(element);
+
+    switch (element->getType()) {
+      case POINT: {
+        element->setVisibility(clipping.pointClipping(element->getVertices().first));
+        break;
+      }
+      case LINE: {
+        element->setVisibility(clipping.lineClipping(static_cast<Line*>(element), lineAlgorithm));
+        break;
+      }
+      case POLYGON: {
+        clipping.polygonClipping(static_cast<Polygon*>(element));
+        break;
+      }
+      case CURVE: {
+        clipping.curveClipping(static_cast<Curve*>(element));
+        break;
+      }
+      case OBJECT3D: {
+        clipping.object3DClipping(static_cast<Object3D*>(element));
+        break;
+      }
+      case MESH3D: {
+        clipping.mesh3DClipping(static_cast<Mesh3D*>(element));
+        break;
+      }
+      case SURFACE: {
+        clipping.surfaceClipping(static_cast<Surface*>(element));
+        break;
+      }
+      default:
+        break;
+    }
+
+    if (element->isVisible()) {
+      toViewport(element);
+    }
+  }
+
+  //! Hands the viewport points of 'element' to the Drawer.
+  void draw(GraphicObject* element) {
+    VertexBuffer& buffer = VertexBuffer::scene();
+
+    switch (element->getType()) {
+      case POINT: {
+        size_t p = element->getVertices().first;
+        drawer.drawPoint(buffer.getXvp(p), buffer.getYvp(p));
+        break;
+      }
+      case LINE: {
+        size_t a = element->getVertices().first;
+        size_t b = a + 1;
+        drawer.drawLine(buffer.getXvp(a), buffer.getYvp(a), buffer.getXvp(b), buffer.getYvp(b));
+        break;
+      }
+      case POLYGON: {
+        Polygon* polygon = static_cast<Polygon*>(element);
+        FrameSpan<Vertex2D> points = polygon->getWindowPoints();
+        drawer.drawPolygon({points.data, points.count}, polygon->fill());
+        break;
+      }
+      case CURVE: {
+        FrameSpan<Vertex2D> points = static_cast<Curve*>(element)->getWindowPoints();
+        drawer.drawCurve({points.data, points.count});
+        break;
+      }
+      case OBJECT3D:
+        drawSegments(static_cast<Object3D*>(element)->getWindowSegments());
+        break;
+      case MESH3D:
+        drawSegments(static_cast<Mesh3D*>(element)->getWindowSegments());
+        break;
+      case SURFACE: {
+        Surface* surface = static_cast<Surface*>(element);
+        const Vertex2D* points = surface->getWindowPoints().data;
+        for (size_t run : surface->getWindowRuns()) {
+          drawer.drawCurve({points, run});
+          points += run;
+        }
+        break;
+      }
+      default:
+        break;
+    }
+  }
+};
+
+#endif  //!< SCENERENDERER_HPP
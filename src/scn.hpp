@@ -1,7 +1,8 @@
 #ifndef SCN_HPP
 #define SCN_HPP
 
-#include "matrix.hpp"
+#include "coordinate.hpp"
+#include "fixedMatrix.hpp"
 
 /*! Transform world coordinates to normalized system coordinates. */
 
@@ -11,24 +12,12 @@ class Scn {
 
     ~Scn () {}
 
-  void transformation(vector<Coordinate*> coordObj, Coordinate* geometriCenter, Coordinate* factor) {
-    Coordinate negCoord(-geometriCenter->getX(), -geometriCenter->getY());
-
-    Matrix translationMatrix(Matrix::translationVectorToMatrix(&negCoord));
-    Matrix scalingMatrix(Matrix::scalingVectorToMatrix(factor));
-
-    Matrix descSCN = translationMatrix * scalingMatrix;
-
-    vector<Coordinate*>::iterator it;
-    for(it = coordObj.begin(); it != coordObj.end(); it++) {
-      Matrix coord(Matrix::coordinateOppToMatrix(*it));
-
-      Matrix translatedObject = descSCN * coord;
-
-      (*it)->setXns(translatedObject.getMatrix()[0][0]);
-      (*it)->setYns(translatedObject.getMatrix()[1][0]);
-    }
+  //! The normalization of projected coordinates into the [-1, 1] window.
+  Mat3 matrix(Coordinate* geometriCenter, Coordinate* factor) {
+    Mat3 translationMatrix = Mat3::translation(-geometriCenter->getX(), -geometriCenter->getY());
+    Mat3 scalingMatrix = Mat3::scaling(factor->getX(), factor->getY());
 
+    return translationMatrix * scalingMatrix;
   }
 };
 
@@ -1,38 +1,27 @@
 #ifndef SEGMENT_HPP
 #define SEGMENT_HPP
 
-#include "coordinate.hpp"
+#include <cstddef>
 
-/*! Structures a representation and behavior of a polygon */
+/*! An edge of an Object3D, between two of its vertices */
 
 class Segment {
 private:
-  vector<Coordinate*> pair;
-  bool visible;
+  size_t a, b;  //!< Indexes of the vertices, relative to the object's first vertex.
 public:
-	Segment(Coordinate* a, Coordinate* b) {
-    this->pair.push_back(a);
-    this->pair.push_back(b);
-    this->visible = true;
+	Segment(size_t a, size_t b) {
+    this->a = a;
+    this->b = b;
 	}
 
-  ~Segment() {
-    delete this->pair.front();
-    delete this->pair.back();
+  size_t getA() const {
+    return this->a;
   }
 
-  vector<Coordinate*> getCoordinates() {
-    return this->pair;
+  size_t getB() const {
+    return this->b;
   }
 
-  bool isVisible() {
-		return this->visible;
-	}
-
-	void setVisibility(bool updateVisibility) {
-		this->visible = updateVisibility;
-	}
-
 };
 
 #endif
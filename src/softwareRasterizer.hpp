@@ -0,0 +1,259 @@
+#ifndef SOFTWARERASTERIZER_HPP
+#define SOFTWARERASTERIZER_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <math.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+#include "renderBackend.hpp"
+#include "scanlineFill.hpp"
+
+using namespace std;
+
+//! Renders into a contiguous RGBA buffer in memory, without Cairo or GTK.
+/*!
+ * Pixels are 4 bytes each (R, G, B, A in memory order), row after row, so
+ * the buffer can be written out as is (@see savePPM(), savePNG()) or handed
+ * to other code through getPixels(). Lines are drawn with Bresenham's
+ * algorithm and polygons are filled by a ScanlineFill (nonzero winding rule,
+ * as Cairo does). Nothing is antialiased.
+ */
+class SoftwareRasterizer : public RenderBackend {
+private:
+  int width, height;
+  vector<uint32_t> pixels;
+  uint32_t color;  //!< Current color, already packed.
+
+  ScanlineFill scanline;  //!< Polygon fill engine, kept between polygons.
+
+  static uint8_t channel(double c) {
+    return (uint8_t) lround(min(1.0, max(0.0, c)) * 255);
+  }
+
+  static uint32_t pack(double r, double g, double b) {
+    uint8_t rgba[4] = {channel(r), channel(g), channel(b), 255};
+    uint32_t packed;
+    memcpy(&packed, rgba, 4);
+    return packed;
+  }
+
+  void plot(int x, int y) {
+    if (x >= 0 && y >= 0 && x < width && y < height)
+      pixels[(size_t) y*width + x] = color;
+  }
+
+  //! Fills the pixels [x0, x1) of row 'y' (already inside the buffer).
+  void span(int y, int x0, int x1) {
+    x0 = max(x0, 0);
+    x1 = min(x1, width);
+    if (x0 < x1)
+      fill(pixels.begin() + (size_t) y*width + x0, pixels.begin() + (size_t) y*width + x1, color);
+  }
+
+  void line(double xa, double ya, double xb, double yb) {
+    int x0 = lround(xa), y0 = lround(ya);
+    int x1 = lround(xb), y1 = lround(yb);
+
+    int dx = abs(x1 - x0), sx = x0 < x1 ? 1 : -1;
+    int dy = -abs(y1 - y0), sy = y0 < y1 ? 1 : -1;
+    int err = dx + dy;
+
+    while (true) {
+      plot(x0, y0);
+      if (x0 == x1 && y0 == y1)
+        break;
+
+      int e2 = 2*err;
+      if (e2 >= dy) {
+        err += dy;
+        x0 += sx;
+      }
+      if (e2 <= dx) {
+        err += dx;
+        y0 += sy;
+      }
+    }
+  }
+
+  //! CRC-32 of 'bytes' continuing from 'crc', as PNG chunks need.
+  static uint32_t crc32(const uint8_t *bytes, size_t size, uint32_t crc = 0) {
+    static uint32_t table[256];
+    static bool ready = false;
+    if (!ready) {
+      for (uint32_t n = 0; n < 256; n++) {
+        uint32_t c = n;
+        for (int k = 0; k < 8; k++)
+          c = c & 1 ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        table[n] = c;
+      }
+      ready = true;
+    }
+
+    crc = ~crc;
+    for (size_t i = 0; i < size; i++)
+      crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+  }
+
+  static void putBigEndian(vector<uint8_t> &out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8)
+      out.push_back((uint8_t) (value >> shift));
+  }
+
+  static bool writeChunk(FILE *file, const char *type, const vector<uint8_t> &data) {
+    vector<uint8_t> chunk;
+    putBigEndian(chunk, data.size());
+    chunk.insert(chunk.end(), type, type + 4);
+    chunk.insert(chunk.end(), data.begin(), data.end());
+    putBigEndian(chunk, crc32(chunk.data() + 4, chunk.size() - 4));
+    return fwrite(chunk.data(), 1, chunk.size(), file) == chunk.size();
+  }
+
+public:
+  SoftwareRasterizer(int width = 0, int height = 0) : width(0), height(0), color(pack(0, 0, 0)) {
+    resize(width, height);
+  }
+
+  void resize(int width, int height) {
+    this->width = max(width, 0);
+    this->height = max(height, 0);
+    pixels.assign((size_t) this->width * this->height, pack(1, 1, 1));
+  }
+
+  void clear(double r, double g, double b) {
+    fill(pixels.begin(), pixels.end(), pack(r, g, b));
+  }
+
+  void setColor(double r, double g, double b) {
+    color = pack(r, g, b);
+  }
+
+  void fillPolygon(PointSpan points) {
+    scanline.fill(points, height, [this](int y, int x0, int x1) { span(y, x0, x1); });
+  }
+
+  void fillPoints(PointSpan points) {
+    for (size_t i = 0; i < points.size(); i++) {
+      int x = lround(points[i].x);
+      int y = lround(points[i].y);
+      for (int dy = -1; dy <= 1; dy++)
+        for (int dx = -1; dx <= 1; dx++)
+          plot(x + dx, y + dy);
+    }
+  }
+
+  void strokePolylines(PointSpan points, const vector<size_t> &runs,
+      const vector<bool> &closed) {
+    size_t first = 0;
+    for (size_t run = 0; run < runs.size(); run++) {
+      size_t end = first + runs[run];
+      for (size_t i = first; i + 1 < end; i++) {
+        line(points[i].x, points[i].y, points[i+1].x, points[i+1].y);
+      }
+      if (closed[run] && runs[run] > 2)
+        line(points[end-1].x, points[end-1].y, points[first].x, points[first].y);
+      first = end;
+    }
+  }
+
+  int getWidth() const {
+    return width;
+  }
+
+  int getHeight() const {
+    return height;
+  }
+
+  //! The frame, 'width' * 'height' RGBA pixels, top row first.
+  const uint32_t* getPixels() const {
+    return pixels.data();
+  }
+
+  //! Writes the frame as a binary PPM (P6) image.
+  /*!
+   * @return false if the file could not be written.
+   */
+  bool savePPM(string fileName) {
+    FILE *file = fopen(fileName.c_str(), "wb");
+    if (!file)
+      return false;
+
+    fprintf(file, "P6\n%d %d\n255\n", width, height);
+
+    vector<uint8_t> row(width*3);
+    for (int y = 0; y < height; y++) {
+      const uint8_t *rgba = (const uint8_t*) &pixels[(size_t) y*width];
+      for (int x = 0; x < width; x++) {
+        row[x*3]     = rgba[x*4];
+        row[x*3 + 1] = rgba[x*4 + 1];
+        row[x*3 + 2] = rgba[x*4 + 2];
+      }
+      fwrite(row.data(), 1, row.size(), file);
+    }
+
+    return fclose(file) == 0;
+  }
+
+  //! Writes the frame as a PNG image (RGB, 8 bits per channel).
+  /*!
+   * The image data is zlib stored without compression, in blocks of up to
+   * 65535 bytes: larger files than a real encoder would make, but no
+   * dependency on zlib or Cairo.
+   *
+   * @return false if the file could not be written.
+   */
+  bool savePNG(string fileName) {
+    // Each row is a filter byte (0, none) and its RGB pixels
+    vector<uint8_t> raw;
+    raw.reserve((size_t) height * (width*3 + 1));
+    for (int y = 0; y < height; y++) {
+      const uint8_t *rgba = (const uint8_t*) &pixels[(size_t) y*width];
+      raw.push_back(0);
+      for (int x = 0; x < width; x++)
+        raw.insert(raw.end(), rgba + x*4, rgba + x*4 + 3);
+    }
+
+    vector<uint8_t> header;
+    putBigEndian(header, width);
+    putBigEndian(header, height);
+    header.insert(header.end(), {8, 2, 0, 0, 0});  // 8 bits, RGB, deflate, no filter, no interlace
+
+    vector<uint8_t> data = {0x78, 0x01};
+    uint32_t a = 1, b = 0;  // Adler-32 of 'raw'
+    for (size_t first = 0; first < raw.size() || first == 0; first += 65535) {
+      size_t size = min(raw.size() - first, (size_t) 65535);
+      bool last = first + size >= raw.size();
+      data.push_back(last ? 1 : 0);
+      data.push_back((uint8_t) size);
+      data.push_back((uint8_t) (size >> 8));
+      data.push_back((uint8_t) ~size);
+      data.push_back((uint8_t) (~size >> 8));
+      data.insert(data.end(), raw.begin() + first, raw.begin() + first + size);
+
+      for (size_t i = first; i < first + size; i++) {
+        a = (a + raw[i]) % 65521;
+        b = (b + a) % 65521;
+      }
+      if (last)
+        break;
+    }
+    putBigEndian(data, b << 16 | a);
+
+    FILE *file = fopen(fileName.c_str(), "wb");
+    if (!file)
+      return false;
+
+    static const uint8_t signature[8] = {137, 'P', 'N', 'G', '\r', '\n', 26, '\n'};
+    bool written = fwrite(signature, 1, 8, file) == 8
+        && writeChunk(file, "IHDR", header)
+        && writeChunk(file, "IDAT", data)
+        && writeChunk(file, "IEND", vector<uint8_t>());
+    return fclose(file) == 0 && written;
+  }
+};
+
+#endif  //!< SOFTWARERASTERIZER_HPP
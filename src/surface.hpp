@@ -1,46 +1,235 @@
 #ifndef SURFACE_HPP
 #define SURFACE_HPP
 
+#include <map>
+
+#include "levelOfDetail.hpp"
 #include "object3D.hpp"
+#include "surfaceBasis.hpp"
+#include "workerPool.hpp"
 
 using namespace std;
 
+//! A grid of rows x columns samples of a surface, stored row after row.
+struct SampleGrid {
+  size_t first;    //!< Vertex of row 0, column 0.
+  size_t rows;
+  size_t columns;
+
+  //! The vertex of row 'r', column 'c'.
+  size_t at(size_t r, size_t c) const {
+    return first + r * columns + c;
+  }
+};
+
+/*! A surface, sampled over grids of points drawn as polylines along their rows and columns */
+
 class Surface: public Object3D {
 protected:
-  vector<Curve*> curves;
+  vector<SampleGrid> grids;                 //!< Each grid is a run of the object's vertices.
+  FrameSpan<Vertex2D> windowPoints;         //!< Visible parts of the rows and columns, one after the other.
+  FrameSpan<size_t> windowRuns;             //!< Number of points of each polyline of 'windowPoints'.
+  vector<Coordinate> controlPoints;         //!< The control grid row after row, none if the surface is just its points.
+  size_t controlColumns;                    //!< Points of each row of the control grid.
+  Basis basis;                              //!< TESSELLATED if there is no control grid.
+  TessellationCache tessellations;
+
+  //! Takes the rows of 'grid' as the control grid, cut to the shortest row.
+  void setControlPoints(const vector<vector<Coordinate> > &grid) {
+    controlColumns = grid.empty() ? 0 : grid[0].size();
+    for (const vector<Coordinate> &row : grid) {
+      controlColumns = min(controlColumns, row.size());
+    }
+
+    controlPoints.clear();
+    controlPoints.reserve(grid.size() * controlColumns);
+    for (const vector<Coordinate> &row : grid) {
+      controlPoints.insert(controlPoints.end(), row.begin(), row.begin() + controlColumns);
+    }
+    tessellations.clear();
+  }
+
+  //! The control point of row 'i', column 'j'.
+  const Coordinate& control(size_t i, size_t j) const {
+    return controlPoints[i * controlColumns + j];
+  }
+
+  size_t controlRows() const {
+    return controlColumns == 0 ? 0 : controlPoints.size() / controlColumns;
+  }
+
+  //! Tessellates the control grid into sample grids within 'tolerance' (world units) of the surface.
+  virtual void tessellate(double tolerance, Tessellation &tessellation) {}
+
+  //! Stores the tessellated points, 'gridSizes' telling the shape of each grid.
+  void storeTessellation(const Tessellation &tessellation) {
+    storeCoordinates(tessellation.xyz);
+    splitGrids(tessellation.gridSizes);
+  }
+
+  //! Makes each run of rows x columns vertices, in order, a grid.
+  /*!
+   * @param gridSizes Rows and columns of each grid, one after the other.
+   */
+  void splitGrids(const vector<size_t> &gridSizes) {
+    grids.clear();
+    size_t first = vertices.first;
+    for (size_t i = 0; i + 1 < gridSizes.size(); i += 2) {
+      grids.push_back({first, gridSizes[i], gridSizes[i + 1]});
+      first += gridSizes[i] * gridSizes[i + 1];
+    }
+  }
+
+  //! Steps keeping the curves of the patch at row 'i', column 'j' within 'tolerance'.
+  /*!
+   * Each curve of the patch is a cubic whose second differences are
+   * weighted means of those of the rows (or columns) of the patch grid.
+   * @param derivativeScale Second derivative of a cubic per unit of second
+   *    difference of its control points: 6 for Bezier, 1 for B-spline.
+   */
+  int patchSteps(int i, int j, double derivativeScale, double tolerance) {
+    double secondDifference = 0;
+    for (int k = 0; k < 4; k++) {
+      secondDifference = max(secondDifference, LevelOfDetail::secondDifference(
+          control(i+k, j), control(i+k, j+1), control(i+k, j+2), control(i+k, j+3)));
+      secondDifference = max(secondDifference, LevelOfDetail::secondDifference(
+          control(i, j+k), control(i+1, j+k), control(i+2, j+k), control(i+3, j+k)));
+    }
+    return LevelOfDetail::steps(derivativeScale * secondDifference, tolerance);
+  }
+
+  //! Tessellates each 4x4 window of the control grid, 'stride' points apart, as a bicubic patch.
+  /*!
+   * Each patch is evaluated over an (n + 1) x (n + 1) grid, n from
+   * patchSteps() within the sample budget of the surface
+   * (@see LevelOfDetail::limitSamples()): its rows are the curves along t and its columns the
+   * curves along s. The basis is tabulated once for each n used by the
+   * patches.
+   *
+   * Patches are tessellated in parallel on 'pool'. Their step counts are
+   * found first, so each patch knows where its points go and writes them
+   * straight into its own slice of the output: no locking, and the result
+   * does not depend on the number of threads.
+   * @param basis Basis matrix of the patches (Mat4::mb() or Mat4::mbs()).
+   */
+  void tessellatePatches(const Mat4 &basis, int stride, double derivativeScale,
+      double tolerance, Tessellation &tessellation, WorkerPool& pool = WorkerPool::shared()) {
+    size_t rows = controlRows() < 4 ? 0 : (controlRows() - 4) / stride + 1;
+    size_t columns = controlColumns < 4 ? 0 : (controlColumns - 4) / stride + 1;
+    size_t patches = rows * columns;
+
+    vector<int> steps(patches);
+    pool.parallelFor(patches, 64, [&](size_t begin, size_t end, unsigned) {
+      for (size_t p = begin; p < end; p++) {
+        steps[p] = patchSteps(p / columns * stride, p % columns * stride, derivativeScale, tolerance);
+      }
+    });
+    LevelOfDetail::limitSamples(steps, 2);
+
+    // Where the points of each patch go, and the basis of each step count
+    map<int, SurfaceBasis> tables;
+    vector<const SurfaceBasis*> bases(patches);
+    vector<size_t> offsets(patches);
+    size_t points = 0;
+    for (size_t p = 0; p < patches; p++) {
+      auto table = tables.find(steps[p]);
+      if (table == tables.end())
+        table = tables.emplace(steps[p], SurfaceBasis(basis, steps[p])).first;
+      bases[p] = &table->second;
+
+      size_t side = steps[p] + 1;
+      offsets[p] = points;
+      points += side * side;
+      tessellation.gridSizes.insert(tessellation.gridSizes.end(), 2, side);
+    }
+
+    vector<double> &xyz = tessellation.xyz;
+    size_t first = xyz.size();
+    xyz.resize(first + 3 * points);
+    pool.parallelFor(patches, 4, [&](size_t begin, size_t end, unsigned) {
+      for (size_t p = begin; p < end; p++) {
+        double* grid = &xyz[first + 3 * offsets[p]];
+        bases[p]->evaluate(PatchPoints::gather(&control(p / columns * stride, p % columns * stride), controlColumns), grid);
+      }
+    });
+  }
 
 public:
-  Surface(string name) : Object3D(name) {
+  Surface(string name) : Object3D(name), windowPoints{NULL, 0}, windowRuns{NULL, 0},
+      controlColumns(0), basis(TESSELLATED) {
     this->type = SURFACE;
   }
 
-  Surface(string name, vector<Curve*> &curves_) :
-      Object3D(name) {
-	  this->curves = curves_;
+  //! A surface already sampled into 'points', 'gridSizes' tells the rows and columns of each grid.
+  Surface(string name, CoordinateSpan points, const vector<size_t> &gridSizes) :
+      Object3D(name), windowPoints{NULL, 0}, windowRuns{NULL, 0}, controlColumns(0),
+      basis(TESSELLATED) {
     this->type = SURFACE;
+    storeCoordinates(points);
+    splitGrids(gridSizes);
+    computeGeometricCenter();
   }
 
-  ~Surface() {
-    vector<Curve*>::iterator it;
-    for(it = curves.begin(); it != curves.end(); it++) {
-      delete *it;
-    }
+  const vector<SampleGrid>& getGrids() {
+    return this->grids;
   }
 
-  vector<Curve*> getCurves() {
-    return this->curves;
+  FrameSpan<Vertex2D> getWindowPoints() {
+    return this->windowPoints;
   }
 
-  void setAllCoordinates() {
-    for (int curve = 0; curve < curves.size(); curve++) {
-      vector<Coordinate*> curveCoords = curves[curve]->getCoordinates();
-      for (int coord = 0; coord < curveCoords.size(); coord++) {
-        addCoordinate(curveCoords[coord]);
-      }
+  FrameSpan<size_t> getWindowRuns() {
+    return this->windowRuns;
+  }
+
+  //! The visible polylines of the surface in the current frame (@see Clipping::surfaceClipping()).
+  void setWindowPolylines(FrameSpan<Vertex2D> points, FrameSpan<size_t> runs) {
+    this->windowPoints = points;
+    this->windowRuns = runs;
+  }
+
+  //! The control grid, row after row.
+  const vector<Coordinate>& getControlPoints() {
+    return this->controlPoints;
+  }
+
+  size_t getControlColumns() {
+    return this->controlColumns;
+  }
+
+  Basis getBasis() {
+    return this->basis;
+  }
+
+  //! Shows the surface at level of detail 'level' (@see LevelOfDetail).
+  /*!
+   * @return false if the points of the surface did not change.
+   */
+  bool setLevel(int level) {
+    if (controlPoints.empty())
+      return false;
+
+    const Tessellation* tessellation = tessellations.select(level,
+        [this](double tolerance, Tessellation &t) { tessellate(tolerance, t); });
+    if (tessellation == NULL)
+      return false;
+
+    storeTessellation(*tessellation);
+    return true;
+  }
+
+  //! Transforms the control grid along with the points of the surface.
+  void transform(const Mat4& transformation) override {
+    Object3D::transform(transformation);
+    for (Coordinate& point : controlPoints) {
+      Vec4 p = transformation * Vec4::point(point.getX(), point.getY(), point.getZ());
+      point = Coordinate(p[0], p[1], p[2]);
     }
+
+    // Scaling changes the error of the tessellations: setLevel() redoes them
+    tessellations.clear();
   }
 
 };
 
 #endif  //!< SURFACE_HPP
-
@@ -0,0 +1,84 @@
+#ifndef SURFACEBASIS_HPP
+#define SURFACEBASIS_HPP
+
+#include <vector>
+
+#include "coordinate.hpp"
+#include "fixedMatrix.hpp"
+
+using namespace std;
+
+//! Control points of a bicubic patch, x, y and z side by side (the 4th lane is padding).
+struct alignas(32) PatchPoints {
+  double p[4][4][4];  //!< [row][column][x, y, z, 0]
+
+  //! The 4x4 window from 'corner' of a grid stored row after row, 'columns' points per row.
+  static PatchPoints gather(const Coordinate* corner, size_t columns) {
+    PatchPoints g;
+    for (int k = 0; k < 4; k++) {
+      for (int l = 0; l < 4; l++) {
+        const Coordinate& c = corner[k * columns + l];
+        g.p[k][l][0] = c.getX();
+        g.p[k][l][1] = c.getY();
+        g.p[k][l][2] = c.getZ();
+        g.p[k][l][3] = 0;
+      }
+    }
+    return g;
+  }
+};
+
+//! The four cubic basis functions of a patch tabulated at t = 0, 1/n ... 1.
+/*!
+ * A bicubic patch is P(s, t) = S M G M^T T^T, S = [s³ s² s 1] and T the
+ * same for t. Row a of the table is [(a/n)³ (a/n)² a/n 1] M, the weight of
+ * each control row (or column) at that parameter, so evaluating the patch
+ * over the (n + 1) x (n + 1) grid is two small contractions over flat
+ * arrays instead of chains of matrix products per point.
+ */
+class SurfaceBasis {
+private:
+  int n;
+  vector<Vec4> weights;  //!< n + 1 rows.
+
+public:
+  SurfaceBasis(const Mat4 &basis, int n) : n(n), weights(n + 1) {
+    for (int a = 0; a <= n; a++) {
+      weights[a] = tVector((double) a / n) * basis;
+    }
+  }
+
+  int steps() const {
+    return n;
+  }
+
+  //! Writes x, y and z of P(a/n, b/n) to grid[3 * (a * (n + 1) + b)], for all a and b.
+  void evaluate(const PatchPoints &g, double* grid) const {
+    for (int a = 0; a <= n; a++) {
+      const Vec4& ws = weights[a];
+
+      // The control points of the curve along t at s = a/n
+      alignas(32) double row[4][4];
+      for (int l = 0; l < 4; l++) {
+        for (int c = 0; c < 4; c++) {
+          row[l][c] = ws[0]*g.p[0][l][c] + ws[1]*g.p[1][l][c]
+                    + ws[2]*g.p[2][l][c] + ws[3]*g.p[3][l][c];
+        }
+      }
+
+      double* out = grid + 3 * a * (n + 1);
+      for (int b = 0; b <= n; b++) {
+        const Vec4& wt = weights[b];
+        alignas(32) double point[4];
+        for (int c = 0; c < 4; c++) {
+          point[c] = wt[0]*row[0][c] + wt[1]*row[1][c] + wt[2]*row[2][c] + wt[3]*row[3][c];
+        }
+        out[3*b] = point[0];
+        out[3*b + 1] = point[1];
+        out[3*b + 2] = point[2];
+      }
+    }
+  }
+};
+
+#endif  //!< SURFACEBASIS_HPP
@@ -0,0 +1,247 @@
+#ifndef VERTEXBUFFER_HPP
+#define VERTEXBUFFER_HPP
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+#include "boundingBox.hpp"
+#include "coordinate.hpp"
+#include "fixedMatrix.hpp"
+
+using namespace std;
+
+//! A contiguous run of vertices inside a VertexBuffer.
+struct VertexRange {
+  size_t first;
+  size_t count;
+
+  size_t end() const {
+    return first + count;
+  }
+};
+
+//! A 2D point produced by clipping (normalized, then viewport coordinates).
+struct Vertex2D {
+  double x;
+  double y;
+};
+
+//! A read-only view of contiguous Vertex2D (e.g. clipped points).
+struct PointSpan {
+  const Vertex2D* data;
+  size_t count;
+
+  static PointSpan of(const vector<Vertex2D> &points) {
+    return {points.data(), points.size()};
+  }
+
+  size_t size() const { return count; }
+  const Vertex2D* begin() const { return data; }
+  const Vertex2D* end() const { return data + count; }
+  const Vertex2D& operator[](size_t i) const { return data[i]; }
+};
+
+//! Read-only world coordinates kept as separate x, y and z arrays.
+struct CoordinateSpan {
+  const double *x, *y, *z;
+  size_t count;
+};
+
+//! Structure-of-arrays storage for the vertices of every graphic object.
+/*!
+ * World coordinates and the output of each stage of the pipeline (normalized
+ * and viewport coordinates) are kept in parallel arrays. A graphic object
+ * only holds the VertexRange of its vertices, so the transformation passes
+ * stream over contiguous memory.
+ */
+class VertexBuffer {
+private:
+  vector<double> x, y, z;   //!< World coordinates.
+  vector<double> xns, yns;  //!< Normalized (window) coordinates.
+  vector<double> xvp, yvp;  //!< ViewPort coordinates.
+
+  vector<VertexRange> freeRanges;  //!< Released ranges, sorted and merged.
+
+  void resize(size_t size) {
+    x.resize(size); y.resize(size); z.resize(size);
+    xns.resize(size); yns.resize(size);
+    xvp.resize(size); yvp.resize(size);
+  }
+
+public:
+  //! The buffer shared by all objects of the scene.
+  static VertexBuffer& scene() {
+    static VertexBuffer buffer;
+    return buffer;
+  }
+
+  size_t size() const {
+    return x.size();
+  }
+
+  //! Reserves 'count' contiguous vertices, reusing released space if possible.
+  VertexRange allocate(size_t count) {
+    if (count == 0)
+      return {0, 0};
+
+    vector<VertexRange>::iterator it;
+    for (it = freeRanges.begin(); it != freeRanges.end(); it++) {
+      if (it->count >= count) {
+        VertexRange range = {it->first, count};
+        it->first += count;
+        it->count -= count;
+        if (it->count == 0)
+          freeRanges.erase(it);
+        return range;
+      }
+    }
+
+    VertexRange range = {size(), count};
+    resize(range.end());
+    return range;
+  }
+
+  //! Gives back the vertices of 'range' to the buffer.
+  void release(VertexRange range) {
+    if (range.count == 0)
+      return;
+
+    vector<VertexRange>::iterator it = lower_bound(freeRanges.begin(), freeRanges.end(), range,
+        [](const VertexRange& a, const VertexRange& b) { return a.first < b.first; });
+    it = freeRanges.insert(it, range);
+
+    // Merge with the following and the previous free ranges
+    if (it + 1 != freeRanges.end() && it->end() == (it + 1)->first) {
+      it->count += (it + 1)->count;
+      freeRanges.erase(it + 1);
+    }
+    if (it != freeRanges.begin() && (it - 1)->end() == it->first) {
+      (it - 1)->count += it->count;
+      it = freeRanges.erase(it) - 1;
+    }
+
+    // Free space at the end is returned to the arrays
+    if (it->end() == size()) {
+      resize(it->first);
+      freeRanges.erase(it);
+    }
+  }
+
+  //! Allocates a range holding the world coordinates of 'coordinates'.
+  VertexRange store(const vector<Coordinate> &coordinates) {
+    VertexRange range = allocate(coordinates.size());
+    for (size_t i = 0; i < coordinates.size(); i++) {
+      setWorld(range.first + i, coordinates[i].getX(), coordinates[i].getY(), coordinates[i].getZ());
+    }
+    return range;
+  }
+
+  //! Allocates a range holding the vertices of 'xyz' (x, y and z of each one in turn).
+  VertexRange store(const vector<double> &xyz) {
+    VertexRange range = allocate(xyz.size() / 3);
+    for (size_t i = 0; i < range.count; i++) {
+      setWorld(range.first + i, xyz[3*i], xyz[3*i + 1], xyz[3*i + 2]);
+    }
+    return range;
+  }
+
+  //! Allocates a range holding the vertices of 'coordinates', copying each array at once.
+  VertexRange store(CoordinateSpan coordinates) {
+    VertexRange range = allocate(coordinates.count);
+    copy(coordinates.x, coordinates.x + range.count, x.begin() + range.first);
+    copy(coordinates.y, coordinates.y + range.count, y.begin() + range.first);
+    copy(coordinates.z, coordinates.z + range.count, z.begin() + range.first);
+    return range;
+  }
+
+  //! Copies the world coordinates of 'range' to the arrays 'toX', 'toY' and 'toZ'.
+  void copyWorld(VertexRange range, double* toX, double* toY, double* toZ) const {
+    copy(x.begin() + range.first, x.begin() + range.end(), toX);
+    copy(y.begin() + range.first, y.begin() + range.end(), toY);
+    copy(z.begin() + range.first, z.begin() + range.end(), toZ);
+  }
+
+  void setWorld(size_t i, double x, double y, double z) {
+    this->x[i] = x;
+    this->y[i] = y;
+    this->z[i] = z;
+  }
+
+  Coordinate getWorld(size_t i) const {
+    return Coordinate(x[i], y[i], z[i]);
+  }
+
+  double getX(size_t i) const { return x[i]; }
+  double getY(size_t i) const { return y[i]; }
+  double getZ(size_t i) const { return z[i]; }
+
+  double getXns(size_t i) const { return xns[i]; }
+  double getYns(size_t i) const { return yns[i]; }
+  double getXvp(size_t i) const { return xvp[i]; }
+  double getYvp(size_t i) const { return yvp[i]; }
+
+  void setNs(size_t i, double x, double y) {
+    xns[i] = x;
+    yns[i] = y;
+  }
+
+  //! The mean of the world coordinates of 'range'.
+  Coordinate center(VertexRange range) const {
+    double cx = 0, cy = 0, cz = 0;
+    for (size_t i = range.first; i < range.end(); i++) {
+      cx += x[i];
+      cy += y[i];
+      cz += z[i];
+    }
+    return Coordinate(cx / range.count, cy / range.count, cz / range.count);
+  }
+
+  //! The largest distance between 'center' and a world coordinate of 'range'.
+  double radius(VertexRange range, const Coordinate& center) const {
+    double r2 = 0;
+    for (size_t i = range.first; i < range.end(); i++) {
+      double dx = x[i] - center.getX();
+      double dy = y[i] - center.getY();
+      double dz = z[i] - center.getZ();
+      r2 = max(r2, dx*dx + dy*dy + dz*dz);
+    }
+    return sqrt(r2);
+  }
+
+  //! Applies 'transform' to the world coordinates of 'range'.
+  void transform(VertexRange range, const Mat4& transform) {
+    for (size_t i = range.first; i < range.end(); i++) {
+      Vec4 p = transform * Vec4::point(x[i], y[i], z[i]);
+      x[i] = p[0];
+      y[i] = p[1];
+      z[i] = p[2];
+    }
+  }
+
+  //! Writes the normalized coordinates of 'range' (homogeneous 'transform' of the world ones).
+  /*!
+   * @return The rectangle bounding the normalized coordinates written.
+   */
+  BoundingRect project(VertexRange range, const Mat4& transform) {
+    BoundingRect bounds = BoundingRect::empty();
+    for (size_t i = range.first; i < range.end(); i++) {
+      Vec4 p = transform * Vec4::point(x[i], y[i], z[i]);
+      xns[i] = p[0] / p[3];
+      yns[i] = p[1] / p[3];
+      bounds.add(xns[i], yns[i]);
+    }
+    return bounds;
+  }
+
+  //! Writes the viewport coordinates of 'range' from the normalized ones.
+  void toViewport(VertexRange range, const Mat3& transform) {
+    for (size_t i = range.first; i < range.end(); i++) {
+      Vec3 p = transform * Vec3::point(xns[i], yns[i]);
+      xvp[i] = p[0];
+      yvp[i] = p[1];
+    }
+  }
+};
+
+#endif  //!< VERTEXBUFFER_HPP
@@ -6,11 +6,15 @@
 #include <stdio.h>
 #include <string>
 
+#include "displayFile.hpp"
+#include "cairoBackend.hpp"
 #include "drawer.hpp"
 #include "logger.hpp"
 #include "orthogonalParallelProjection.hpp"
 #include "perspectiveProjection.hpp"
 #include "scn.hpp"
+#include "sceneRenderer.hpp"
+#include "viewPipeline.hpp"
 #include "viewport.hpp"
 #include "window.hpp"
 
@@ -83,12 +87,15 @@ private:
   GtkAdjustment *scaleValues;
 
   Drawer* drawer;
+  CairoBackend* backend;  //!< Owned by 'drawer', shown on the drawing area.
   Window* window;
   ViewPort* viewPort;
   Scn* scn;
   Logger* logger;
   Opp* opp;
   Perspective* pers;
+  ViewPipeline* pipeline;
+  SceneRenderer* renderer;
 
   int rotationRadioButtonState;
   int clippingRadioButtonState;
@@ -99,12 +106,15 @@ private:
   bool checkIsSplineSurfaceState;
 
 public:
-  View() {
-    drawer = new Drawer();
+  View() : window(NULL), viewPort(NULL) {
+    backend = new CairoBackend();
+    drawer = new Drawer(backend);
     scn = new Scn();
     logger = new Logger();
     opp = new Opp();
     pers = new Perspective();
+    pipeline = new ViewPipeline();
+    renderer = new SceneRenderer(*pipeline, *drawer);
   }
 
   //! Startup the user interface: initiates GTK, creates all graphical elements and runs gtk_main();
@@ -208,10 +218,11 @@ public:
     Coordinate* wCoordMax = new Coordinate(xMax/2, yMax/2, 0);
     vector<Coordinate*> windowCoord = {wCoordMin, wCoordMax};
 
+    // Called again whenever the main window is resized: drop the old ones
+    delete viewPort;
+    delete window;
     window = new Window(windowCoord);
     viewPort = new ViewPort(vpCoord, window);
-
-    drawViewPortArea();
   }
 
   void openAddObjectWindow() {
@@ -223,61 +234,18 @@ public:
   }
 
   void create_surface(GtkWidget *widget) {
-    drawer->create_surface(widget);
+    backend->resize(gtk_widget_get_allocated_width(widget)-10,
+                    gtk_widget_get_allocated_height(widget)-10);
   }
 
   void draw(cairo_t *cr) {
-    drawer->draw(cr);
+    backend->present(cr);
   }
 
   void drawViewPortArea() {
     drawer->drawViewPortArea(getViewPortCoord().back(), VIEWPORT_MARGIN);
   }
 
-  void drawNewPoint(Point* obj) {
-    drawer->drawPoint(obj->getCoordinates().front());
-    gtk_widget_queue_draw((GtkWidget*) drawAreaViewPort);
-  }
-
-  void drawNewLine(Line* obj) {
-    drawer->drawLine(obj->getCoordinates().front(), obj->getCoordinates().back());
-    gtk_widget_queue_draw((GtkWidget*) drawAreaViewPort);
-  }
-
-  void drawNewPolygon(Polygon* obj, bool fill) {
-    vector<Coordinate*> polygonPoints = obj->getWindowPoints();
-
-    drawer->drawPolygon(polygonPoints, fill);
-    gtk_widget_queue_draw((GtkWidget*) drawAreaViewPort);
-  }
-
-  void drawNewCurve(Curve* obj) {
-    vector<Coordinate*> points = obj->getWindowPoints();
-
-    drawer->drawCurve(points);
-    gtk_widget_queue_draw((GtkWidget*) drawAreaViewPort);
-  }
-
-  void drawNewSurface(Surface* obj) {
-    vector<Curve*> curves = obj->getCurves();
-    vector<Curve*>::iterator curve;
-    for(curve = curves.begin(); curve != curves.end(); curve++) {
-      drawNewCurve(*curve);
-    }
-  }
-
-  void drawNewObject3D(Object3D* obj) {
-    vector<Segment*> segments = static_cast<Object3D*>(obj)->getSegmentList();
-    vector<Segment*>::iterator segment;
-    for(segment = segments.begin(); segment != segments.end(); segment++) {
-      if ((*segment)->isVisible()) {
-        vector<Coordinate*> tmp = (*segment)->getCoordinates();
-        drawer->drawLine(tmp[0], tmp[1]);
-      }
-    }
-    gtk_widget_queue_draw((GtkWidget*) drawAreaViewPort);
-  }
-
   void clearPolygonEntry() {
     removeAllCoordinates(listCoordPolygon);
     clearCoordEntries(entryPolygonX, entryPolygonY, entryPolygonZ);
@@ -299,11 +267,16 @@ public:
     clearCoordEntries(entry3DX2, entry3DY2, entry3DZ2);
   }
 
-  void insertIntoListBox(GraphicObject& obj, string tipo) {
+  //! Adds a row for 'obj' to the object list, remembering its DisplayFile handle.
+  void insertIntoListBox(GraphicObject& obj, string tipo, ObjectHandle handle) {
     GtkWidget* row = gtk_list_box_row_new();
     GtkWidget* label = gtk_label_new((obj.getObjectName() + " (" + tipo + ")").c_str());
 
-    gtk_container_add((GtkContainer*) objectsListBox, label);
+    g_object_set_data(G_OBJECT(row), "slot", GUINT_TO_POINTER(handle.slot));
+    g_object_set_data(G_OBJECT(row), "generation", GUINT_TO_POINTER(handle.generation));
+
+    gtk_container_add((GtkContainer*) row, label);
+    gtk_container_add((GtkContainer*) objectsListBox, row);
     gtk_widget_show_all((GtkWidget*) objectsListBox);
   }
 
@@ -386,6 +359,7 @@ public:
 
   void updateClippingRadioBtnState(int newState) {
     clippingRadioButtonState = newState;
+    pipeline->invalidate();  // lines must be clipped again
   }
 
   void updateCheckBtnState () {
@@ -455,45 +429,6 @@ public:
     }
   }
 
-  //! Calls ViewPort::transformation() for each point of 'object'
-  /*!
-   * @param object The GraphicObject that its coordinates will be transformed to
-   * 	corresponding ViewPort coordinates.
-   */
-  void transform(GraphicObject* object) {
-    switch (object->getType()) {
-      case POINT:
-        this->worldToViewPort(static_cast<GraphicObject2D*>(object)->getCoordinates());
-        break;
-      case LINE:
-        this->worldToViewPort(static_cast<GraphicObject2D*>(object)->getCoordinates());
-        break;
-      case POLYGON:
-        this->worldToViewPort(static_cast<Polygon*>(object)->getWindowPoints());
-        break;
-      case CURVE:
-        this->worldToViewPort(static_cast<Curve*>(object)->getWindowPoints());
-        break;
-      case OBJECT3D:
-        this->worldToViewPort(static_cast<Object3D*>(object)->getAllCoord());
-        break;
-      case SURFACE:
-        vector<Curve*> curves = static_cast<Surface*>(object)->getCurves();
-        vector<Curve*>::iterator curve;
-        for (curve = curves.begin(); curve != curves.end(); curve++) {
-          this->worldToViewPort(static_cast<Curve*>(*curve)->getWindowPoints());
-        }
-        break;
-    }
-  }
-
-  void worldToViewPort(vector<Coordinate*> points) {
-    vector<Coordinate*>::iterator it;
-    for(it = points.begin(); it != points.end(); it++) {
-      viewPort->transformation(*it);
-    }
-  }
-
   string chooseFile() {
     string fileName;
     GtkWidget *dialog;
@@ -546,48 +481,53 @@ public:
     pers->transformation(window->getCoordinates(), &xa , cop);
   }
 
-  void transformProjection(GraphicObject* obj, Coordinate* cop) {
+  //! Composes the world to viewport transformation for the next frame.
+  /*!
+   * Projects the window (@see computeAngleForProjection()) and derives the
+   * projection, SCN and viewport matrices from it.
+   */
+  void beginFrame(Coordinate* cop) {
+    computeAngleForProjection(cop);
+
     Coordinate geometriCenter = window->getGeometricCenter();
-    if (getProjectionBtnState())
-      transformOPP(obj, &geometriCenter);
-    else
-      transformPerspective(obj, cop);
+    Mat4 projection = getProjectionBtnState() ?
+        opp->matrix(&geometriCenter) : pers->matrix(&geometriCenter, cop);
+
+    Coordinate* windowCoord = window->getCoordinates().back();
+    Coordinate scalingFactor(1/windowCoord->getXop(), 1/windowCoord->getYop());
+
+    pipeline->update(projection, scn->matrix(&geometriCenter, &scalingFactor),
+        viewPort->matrix(), window->getAngleX(), window->getAngleY(), window->getAngleZ());
   }
 
-  void transformOPP(GraphicObject* elem, Coordinate* vrp) {
-    if (elem->getType() != OBJECT3D && elem->getType() != SURFACE) {
-      opp->transformation(
-                  static_cast<GraphicObject2D*>(elem)->getCoordinates(), vrp);
-    } else {
-      opp->transformation(static_cast<Object3D*>(elem)->getAllCoord(), vrp);
-    }
+  //! The flatness tolerance of curves (@see CURVE_FLATNESS) in world units, at the current zoom.
+  double curveTolerance() {
+    Coordinate* windowMin = window->getCoordinates().front();
+    Coordinate* windowMax = window->getCoordinates().back();
+    Coordinate* viewPortMin = viewPort->getCoordinates().front();
+    Coordinate* viewPortMax = viewPort->getCoordinates().back();
+    double pixelSize = (windowMax->getX() - windowMin->getX()) / (viewPortMax->getX() - viewPortMin->getX());
+    return CURVE_FLATNESS * pixelSize;
   }
 
-  void transformPerspective(GraphicObject* elem, Coordinate* cop) {
-    Coordinate xa = window->getGeometricCenter();
-    if (elem->getType() != OBJECT3D && elem->getType() != SURFACE) {
-      pers->transformation(
-              static_cast<GraphicObject2D*>(elem)->getCoordinates(), &xa, cop);
-    } else {
-      pers->transformation(static_cast<Object3D*>(elem)->getAllCoord(), &xa, cop);
-    }
+  //! World to normalized coordinates matrix of the current frame (@see beginFrame()).
+  const Mat4& frameMatrix() {
+    return pipeline->getProjection();
   }
 
-  void transformSCN(GraphicObject* elem) {
-    window->computePersGeometricCenter();
+  //! Version of the frame matrices (@see ViewPipeline::getVersion()).
+  size_t frameVersion() {
+    return pipeline->getVersion();
+  }
 
-    Coordinate* windowCoord = window->getCoordinates().back();
-    Coordinate geometriCenter = window->getGeometricCenter();
-    Coordinate scalingFactor(1/windowCoord->getXop(), 1/windowCoord->getYop());
+  //! Re-tessellates 'object' for the current frame (@see SceneRenderer::updateLevelOfDetail()).
+  bool updateLevelOfDetail(GraphicObject* object) {
+    return renderer->updateLevelOfDetail(object);
+  }
 
-    if (elem->getType() != OBJECT3D && elem->getType() != SURFACE) {
-      scn->transformation(
-                      static_cast<GraphicObject2D*>(elem)->getCoordinates(),
-                      &geometriCenter,
-                      &scalingFactor);
-    } else {
-      scn->transformation(static_cast<Object3D*>(elem)->getAllCoord(), &geometriCenter, &scalingFactor);
-    }
+  //! Projects, clips and draws 'objects' into the current frame.
+  void render(const vector<GraphicObject*> &objects) {
+    renderer->render(objects, getLineClippingAlgorithm());
   }
 
   void logWarning(string wrn) {
@@ -598,9 +538,29 @@ public:
     logger->logError(err);
   }
 
-  void clear_surface() {
-    drawer->clear_surface();
-    gtk_widget_queue_draw((GtkWidget*) drawAreaViewPort);
+  //! Starts drawing a new frame (@see Drawer::beginFrame()).
+  void beginDrawing() {
+    drawer->beginFrame();
+  }
+
+  //! Submits the frame and asks GTK to show it.
+  /*!
+   * May run outside the GTK main loop (@see RenderThread), so the widget is
+   * only invalidated from there, through g_idle_add().
+   */
+  void endDrawing() {
+    drawer->endFrame();
+    g_idle_add(queueDraw, drawAreaViewPort);
+  }
+
+  static gboolean queueDraw(gpointer widget) {
+    gtk_widget_queue_draw((GtkWidget*) widget);
+    return G_SOURCE_REMOVE;
+  }
+
+  //! Whether the window and the viewport exist (@see initializeWindowViewPort()).
+  bool hasWindow() {
+    return window != NULL && viewPort != NULL;
   }
 
   void clearSaveWorldFile() {
@@ -781,15 +741,34 @@ public:
     return gtk_adjustment_get_value(scaleValues);
   }
 
-  int getCurrentObjectIndex() {
+  //! The DisplayFile handle of the selected object (generation 0 if none).
+  ObjectHandle getSelectedObject() {
     GtkListBoxRow* row = gtk_list_box_get_selected_row(objectsListBox);
     if (row == NULL) {
-      return -1;
+      return {0, 0};
     } else {
-      return gtk_list_box_row_get_index(row);
+      return rowHandle(row);
     }
   }
 
+  //! Removes the selected row of the object list and returns its handle.
+  ObjectHandle removeSelectedObject() {
+    GtkListBoxRow* row = gtk_list_box_get_selected_row(objectsListBox);
+    if (row == NULL) {
+      logger->logError("Nenhum objeto selecionado!\n");
+      return {0, 0};
+    }
+
+    ObjectHandle handle = rowHandle(row);
+    gtk_container_remove((GtkContainer*) objectsListBox, (GtkWidget*) row);
+    return handle;
+  }
+
+  ObjectHandle rowHandle(GtkListBoxRow* row) {
+    return {GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(row), "slot")),
+            GPOINTER_TO_UINT(g_object_get_data(G_OBJECT(row), "generation"))};
+  }
+
   int getRotationRadioButtonState() {
     return rotationRadioButtonState;
   }
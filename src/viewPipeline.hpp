@@ -0,0 +1,141 @@
+#ifndef VIEWPIPELINE_HPP
+#define VIEWPIPELINE_HPP
+
+#include <math.h>
+#include <vector>
+
+#include "coordinate.hpp"
+#include "fixedMatrix.hpp"
+#include "frameArena.hpp"
+#include "objectTransformation.hpp"
+#include "vertexBuffer.hpp"
+
+using namespace std;
+
+//! The world to viewport transformation of one frame.
+/*!
+ * Camera rotation, projection (parallel or perspective), SCN normalization
+ * and viewport mapping are composed once per frame, so each vertex is
+ * transformed by a single matrix instead of going through every stage.
+ *
+ * The camera rotates each object around its own geometric center, so the
+ * world to normalized matrix is finished per object by objectMatrix(). The
+ * viewport mapping is kept apart because clipping runs on normalized
+ * coordinates, between project() and toViewport().
+ *
+ * Each distinct set of frame matrices gets a new version, so objects can
+ * keep their projected points while neither they nor the camera change.
+ */
+class ViewPipeline {
+private:
+  Mat4 projection;  //!< Projection followed by SCN normalization (homogeneous).
+  Mat3 viewport;    //!< Normalized coordinates to viewport coordinates.
+  double angleX, angleY, angleZ;  //!< Camera angles, in degrees.
+  size_t version;  //!< Changes whenever the frame matrices change (never 0).
+
+  //! Lifts a 2D homogeneous transformation to act on the (x, y, w) of a Vec4.
+  static Mat4 liftXY(const Mat3& a) {
+    return {{{a.m[0][0], a.m[0][1], 0, a.m[0][2]},
+             {a.m[1][0], a.m[1][1], 0, a.m[1][2]},
+             {    0    ,     0    , 1,     0    },
+             {a.m[2][0], a.m[2][1], 0, a.m[2][2]}}};
+  }
+
+public:
+  ViewPipeline() : projection(Mat4::identity()), viewport(Mat3::identity()),
+      angleX(0), angleY(0), angleZ(0), version(1) {}
+
+  //! Composes the frame matrices.
+  /*!
+   * @param projection World (after camera rotation) to projected coordinates.
+   * @param scn Projected to normalized coordinates.
+   * @param viewport Normalized to viewport coordinates.
+   */
+  void update(const Mat4& projection, const Mat3& scn, const Mat3& viewport,
+      double angleX, double angleY, double angleZ) {
+    Mat4 composed = liftXY(scn) * projection;
+    if (!(composed == this->projection && viewport == this->viewport
+        && angleX == this->angleX && angleY == this->angleY && angleZ == this->angleZ)) {
+      invalidate();
+    }
+
+    this->projection = composed;
+    this->viewport = viewport;
+    this->angleX = angleX;
+    this->angleY = angleY;
+    this->angleZ = angleZ;
+  }
+
+  //! Discards the projections cached for the current frame matrices.
+  void invalidate() {
+    this->version++;
+  }
+
+  //! World to normalized coordinates matrix, without the camera rotation.
+  const Mat4& getProjection() const {
+    return this->projection;
+  }
+
+  size_t getVersion() const {
+    return this->version;
+  }
+
+  //! World to normalized coordinates matrix of an object centered at geoCenter.
+  Mat4 objectMatrix(Coordinate* geoCenter) const {
+    return projection * ObjectTransformation::cameraRotation(geoCenter, angleX, angleY, angleZ);
+  }
+
+  //! How many pixels a world unit spans around 'points', for an object centered at geoCenter.
+  /*!
+   * Compares the diagonal of the box bounding 'points' in the world with
+   * that of the rectangle bounding them on the viewport. Points behind the
+   * center of projection are left out.
+   */
+  double pixelsPerUnit(const vector<Coordinate> &points, Coordinate* geoCenter) const {
+    Mat4 transform = objectMatrix(geoCenter);
+    BoundingBox world = BoundingBox::empty();
+    BoundingRect screen = BoundingRect::empty();
+    for (const Coordinate& point : points) {
+      world.merge(BoundingBox::around(point.getX(), point.getY(), point.getZ(), 0));
+
+      Vec4 p = transform * Vec4::point(point.getX(), point.getY(), point.getZ());
+      if (p[3] <= 0)
+        continue;
+      Vec3 v = viewport * Vec3::point(p[0] / p[3], p[1] / p[3]);
+      screen.add(v[0], v[1]);
+    }
+
+    double worldX = world.max[0] - world.min[0];
+    double worldY = world.max[1] - world.min[1];
+    double worldZ = world.max[2] - world.min[2];
+    double worldDiagonal = sqrt(worldX*worldX + worldY*worldY + worldZ*worldZ);
+    if (!(worldDiagonal > 0) || screen.minX > screen.maxX)
+      return 0;
+
+    double screenX = screen.maxX - screen.minX;
+    double screenY = screen.maxY - screen.minY;
+    return sqrt(screenX*screenX + screenY*screenY) / worldDiagonal;
+  }
+
+  //! Transforms the world coordinates of 'range' into normalized coordinates with 'transform'.
+  BoundingRect project(VertexRange range, const Mat4& transform) const {
+    return VertexBuffer::scene().project(range, transform);
+  }
+
+  //! Transforms the normalized coordinates of 'range' into viewport coordinates.
+  void toViewport(VertexRange range) const {
+    VertexBuffer::scene().toViewport(range, viewport);
+  }
+
+  //! Transforms clipped points from normalized into viewport coordinates, in place.
+  void toViewport(FrameSpan<Vertex2D> points) const {
+    for (Vertex2D& point : points) {
+      Vec3 p = viewport * Vec3::point(point.x, point.y);
+
+      point.x = p[0];
+      point.y = p[1];
+    }
+  }
+};
+
+#endif  //!< VIEWPIPELINE_HPP
@@ -1,6 +1,7 @@
 #ifndef VIEWPORT_HPP
 #define VIEWPORT_HPP
 
+#include "fixedMatrix.hpp"
 #include "window.hpp"
 
 class ViewPort {
@@ -25,10 +26,10 @@ class ViewPort {
 
 	//! The viewport (coordinates system) transformation
 	/*!
-	 * Transforms coord into a Coordinate referred to the viewport.
-	 * @param coord The window coordinate to be transformed into a viewport coordinate.
+	 * Maps normalized (window) coordinates into coordinates referred to the
+	 * viewport.
 	 */
-   void transformation(Coordinate *coord) {
+    Mat3 matrix() {
       // Normalized coordinate system
       double xnsMax = 1;
       double ynsMax = 1;
@@ -40,11 +41,14 @@ class ViewPort {
       double xvpMin = vpCoord.front()->getX();
       double yvpMin = vpCoord.front()->getY();
 
-      double x = (( (coord->getXns() - xnsMin) / (xnsMax - xnsMin) ) * (xvpMax - xvpMin)) + xvpMin;
-      double y = ((1 - (coord->getYns() - ynsMin)/ (ynsMax - ynsMin) ) * (yvpMax - yvpMin)) + yvpMin;
+      double sx = (xvpMax - xvpMin) / (xnsMax - xnsMin);
+      double sy = (yvpMax - yvpMin) / (ynsMax - ynsMin);
 
-      coord->setXvp(x);
-      coord->setYvp(y);
+      // x = ((xns - xnsMin) / (xnsMax - xnsMin)) * (xvpMax - xvpMin) + xvpMin
+      // y = (1 - (yns - ynsMin) / (ynsMax - ynsMin)) * (yvpMax - yvpMin) + yvpMin
+      return {{{sx,  0 , xvpMin - xnsMin*sx},
+               {0 , -sy, yvpMax + ynsMin*sy},
+               {0 ,  0 ,        1          }}};
     }
 };
 
@@ -6,8 +6,9 @@
  * The graphical world moves (horizontally, vertically, diagonally) and the window
  * shows a limited area of it.
  */
-class Window: public GraphicObject2D {
+class Window: public GraphicObject {
 private:
+  vector<Coordinate*> coordinateList;  //!< The window keeps its own corners (it is not part of the scene).
   Coordinate const *defaultCoordMin;
   Coordinate const *defaultCoordMax;
   double angleX;
@@ -16,7 +17,7 @@ private:
 
 public:
   Window(vector<Coordinate*> &windowCoordinates) :
-    GraphicObject2D("Window", WINDOW, windowCoordinates) {
+    GraphicObject("Window", WINDOW), coordinateList(windowCoordinates) {
 
     this->angleX = 0;
     this->angleY = 0;
@@ -31,6 +32,27 @@ public:
   ~Window() {
     delete this->defaultCoordMax;
     delete this->defaultCoordMin;
+    for (Coordinate* c : coordinateList)
+      delete c;
+  }
+
+  vector<Coordinate*>& getCoordinates() {
+    return this->coordinateList;
+  }
+
+  void computeGeometricCenter() override {
+    cx = 0;
+    cy = 0;
+    cz = 0;
+    vector<Coordinate*>::iterator it;
+    for(it = this->coordinateList.begin(); it != this->coordinateList.end(); it++) {
+      cx += (*it)->getX();
+      cy += (*it)->getY();
+      cz += (*it)->getZ();
+    }
+    cx = cx / this->coordinateList.size();
+    cy = cy / this->coordinateList.size();
+    cz = cz / this->coordinateList.size();
   }
 
   void setAngleX(int newAngle) {
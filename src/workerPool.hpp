@@ -0,0 +1,180 @@
+#ifndef WORKERPOOL_HPP
+#define WORKERPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+//! A fixed set of threads running parallel loops with work stealing.
+/*!
+ * parallelFor() cuts the loop in chunks and deals them, in contiguous
+ * blocks, to one queue per participant (the workers and the calling thread,
+ * which works too). Each participant takes chunks from the front of its own
+ * queue and, once it is empty, steals from the back of the others', so a
+ * participant that got the expensive objects does not hold everyone back.
+ */
+class WorkerPool {
+public:
+  //! Runs the iterations [begin, end) on participant 'participant' (0 is the caller).
+  typedef function<void(size_t begin, size_t end, unsigned participant)> Body;
+
+private:
+  struct Chunk {
+    size_t begin, end;
+  };
+
+  struct Queue {
+    mutex lock;
+    deque<Chunk> chunks;
+  };
+
+  vector<thread> threads;
+  vector<unique_ptr<Queue>> queues;  //!< One per participant.
+
+  mutex lock;
+  condition_variable wake;      //!< A loop was started, or the pool is stopping.
+  condition_variable finished;  //!< The last chunk or the last worker of a loop is done.
+  const Body* body;             //!< Loop being run, NULL between loops.
+  size_t generation;            //!< Incremented for each loop.
+  unsigned running;             //!< Workers that have not left the current loop.
+  bool stopping;
+  atomic<size_t> remaining;     //!< Chunks of the current loop not yet done.
+
+  //! Takes a chunk from the own queue or, failing that, from another one.
+  bool take(unsigned participant, Chunk& chunk) {
+    {
+      Queue& own = *queues[participant];
+      lock_guard<mutex> guard(own.lock);
+      if (!own.chunks.empty()) {
+        chunk = own.chunks.front();
+        own.chunks.pop_front();
+        return true;
+      }
+    }
+
+    for (unsigned i = 1; i < queues.size(); i++) {
+      Queue& victim = *queues[(participant + i) % queues.size()];
+      lock_guard<mutex> guard(victim.lock);
+      if (!victim.chunks.empty()) {
+        chunk = victim.chunks.back();
+        victim.chunks.pop_back();
+        return true;
+      }
+    }
+    return false;
+  }
+
+  //! Runs chunks of the current loop until none is left.
+  void work(unsigned participant, const Body& body) {
+    Chunk chunk;
+    while (take(participant, chunk)) {
+      body(chunk.begin, chunk.end, participant);
+      if (remaining.fetch_sub(1) == 1) {
+        lock_guard<mutex> guard(lock);
+        finished.notify_all();
+      }
+    }
+  }
+
+  void workerLoop(unsigned participant) {
+    size_t seen = 0;
+    while (true) {
+      const Body* current;
+      {
+        unique_lock<mutex> guard(lock);
+        wake.wait(guard, [&] { return stopping || generation != seen; });
+        if (stopping)
+          return;
+        seen = generation;
+        current = body;
+        if (!current)
+          continue;  // woke up after the loop was over
+        running++;
+      }
+
+      work(participant, *current);
+
+      lock_guard<mutex> guard(lock);
+      if (--running == 0)
+        finished.notify_all();
+    }
+  }
+
+public:
+  //! @param workers Threads besides the caller (none runs loops serially).
+  WorkerPool(unsigned workers) : body(NULL), generation(0), running(0),
+      stopping(false), remaining(0) {
+    for (unsigned i = 0; i <= workers; i++)
+      queues.emplace_back(new Queue());
+    for (unsigned i = 1; i <= workers; i++)
+      threads.emplace_back(&WorkerPool::workerLoop, this, i);
+  }
+
+  ~WorkerPool() {
+    {
+      lock_guard<mutex> guard(lock);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (thread& t : threads)
+      t.join();
+  }
+
+  //! The pool shared by the whole program, with a worker per extra core.
+  static WorkerPool& shared() {
+    static WorkerPool pool(max(1u, thread::hardware_concurrency()) - 1);
+    return pool;
+  }
+
+  //! Number of participants, so callers can keep per participant state.
+  unsigned size() const {
+    return queues.size();
+  }
+
+  //! Runs 'body' over [0, count) in chunks of 'grain' iterations and waits for it.
+  void parallelFor(size_t count, size_t grain, const Body& body) {
+    if (count == 0)
+      return;
+
+    grain = max(grain, (size_t) 1);
+    size_t chunks = (count + grain - 1) / grain;
+    if (threads.empty() || chunks == 1) {
+      body(0, count, 0);
+      return;
+    }
+
+    // Participant p gets the chunks [p*chunks/n, (p+1)*chunks/n)
+    size_t n = queues.size();
+    for (size_t p = 0; p < n; p++) {
+      Queue& queue = *queues[p];
+      lock_guard<mutex> guard(queue.lock);
+      for (size_t c = p*chunks/n; c < (p+1)*chunks/n; c++)
+        queue.chunks.push_back({c*grain, min(count, (c+1)*grain)});
+    }
+    remaining = chunks;
+
+    {
+      lock_guard<mutex> guard(lock);
+      this->body = &body;
+      generation++;
+    }
+    wake.notify_all();
+
+    work(0, body);
+
+    // Workers may still be looking for chunks to steal: 'body' must outlive them
+    unique_lock<mutex> guard(lock);
+    finished.wait(guard, [&] { return remaining == 0 && running == 0; });
+    this->body = NULL;
+  }
+};
+
+#endif  //!< WORKERPOOL_HPP